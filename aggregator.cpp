@@ -0,0 +1,41 @@
+#include "aggregator.h"
+
+Aggregator::Aggregator(const CryptoContext<DCRTPoly>& cc, ThreadPool* pool) : cc(cc), pool(pool) {}
+
+Ciphertext<DCRTPoly> Aggregator::Aggregate(const std::vector<Ciphertext<DCRTPoly>>& ciphertexts) const {
+    return (pool != nullptr) ? AggregateTree(ciphertexts) : AggregateLinear(ciphertexts);
+}
+
+Ciphertext<DCRTPoly> Aggregator::AggregateLinear(const std::vector<Ciphertext<DCRTPoly>>& ciphertexts) const {
+    if (ciphertexts.empty()) {
+        OPENFHE_THROW(openfhe_error, "No ciphertexts to aggregate");
+    }
+
+    Ciphertext<DCRTPoly> result = ciphertexts[0]->Clone();
+    for (size_t i = 1; i < ciphertexts.size(); ++i) {
+        cc->EvalAddInPlace(result, ciphertexts[i]);
+    }
+    return result;
+}
+
+Ciphertext<DCRTPoly> Aggregator::AggregateTree(const std::vector<Ciphertext<DCRTPoly>>& ciphertexts) const {
+    if (ciphertexts.empty()) {
+        OPENFHE_THROW(openfhe_error, "No ciphertexts to aggregate");
+    }
+    if (pool == nullptr) {
+        OPENFHE_THROW(openfhe_error, "Tree aggregation needs a thread pool");
+    }
+
+    // First level: the inputs belong to the caller, so the pair sums go into
+    // fresh ciphertexts that the remaining levels may overwrite.
+    const size_t n = ciphertexts.size();
+    std::vector<Ciphertext<DCRTPoly>> partialSums((n + 1) / 2);
+    pool->ParallelFor(0, partialSums.size(), [&](size_t k) {
+        size_t i       = 2 * k;
+        partialSums[k] = (i + 1 < n) ? cc->EvalAdd(ciphertexts[i], ciphertexts[i + 1]) : ciphertexts[i]->Clone();
+    });
+
+    return pool->TreeReduce(std::move(partialSums), [&](Ciphertext<DCRTPoly>& acc, const Ciphertext<DCRTPoly>& other) {
+        cc->EvalAddInPlace(acc, other);
+    });
+}
@@ -0,0 +1,45 @@
+#ifndef OPENFHE_AGGREGATOR_H
+#define OPENFHE_AGGREGATOR_H
+
+#include "openfhe.h"
+
+#include "threadpool.h"
+
+#include <vector>
+
+using namespace lbcrypto;
+
+/**
+ * Sums the FHE ciphertexts produced by the parties into one aggregate.
+ */
+class Aggregator {
+public:
+    /**
+     * @param pool - workers for the tree reduction; without a pool Aggregate()
+     *               falls back to the sequential chain
+     */
+    explicit Aggregator(const CryptoContext<DCRTPoly>& cc, ThreadPool* pool = nullptr);
+
+    /**
+     * Returns the homomorphic sum of all ciphertexts; the inputs are not modified.
+     */
+    Ciphertext<DCRTPoly> Aggregate(const std::vector<Ciphertext<DCRTPoly>>& ciphertexts) const;
+
+    /**
+     * Sequential EvalAddInPlace chain over all ciphertexts.
+     */
+    Ciphertext<DCRTPoly> AggregateLinear(const std::vector<Ciphertext<DCRTPoly>>& ciphertexts) const;
+
+    /**
+     * Pairwise reduction tree whose levels run in parallel on the pool. The
+     * first level writes into new ciphertexts, every later level adds in place
+     * into the left operand's buffer, so no further ciphertexts are allocated.
+     */
+    Ciphertext<DCRTPoly> AggregateTree(const std::vector<Ciphertext<DCRTPoly>>& ciphertexts) const;
+
+private:
+    CryptoContext<DCRTPoly> cc;
+    ThreadPool* pool;
+};
+
+#endif  //OPENFHE_AGGREGATOR_H
@@ -0,0 +1,93 @@
+#include "openfhe.h"
+
+#include "aggregator.h"
+#include "encoder.h"
+#include "threadpool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+
+using namespace lbcrypto;
+
+// Linear EvalAddInPlace chain vs. parallel tree reduction of N party ciphertexts.
+//
+// usage: bench_aggregation [threads] [max-parties]
+
+// distinct encryptions; larger party counts reuse them (addition cost does not depend on the payload)
+const size_t DISTINCTCIPHERTEXTS = 64;
+const int REPETITIONS            = 3;
+
+double MedianMs(std::vector<double> samples) {
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+template <typename F>
+double TimeMs(F&& f) {
+    auto start = std::chrono::high_resolution_clock::now();
+    f();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    size_t numThreads = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 0;
+    size_t maxParties = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 10000;
+
+    // same ciphertext shape as the SA to FHE pipeline
+    usint batchSize = 16;
+    CCParams<CryptoContextCKKSRNS> parameters;
+    parameters.SetSecurityLevel(HEStd_128_classic);
+    parameters.SetMultiplicativeDepth(6);
+    parameters.SetScalingModSize(50);
+    parameters.SetBatchSize(batchSize);
+
+    CryptoContext<DCRTPoly> cc = GenCryptoContext(parameters);
+    cc->Enable(PKE);
+    cc->Enable(KEYSWITCH);
+    cc->Enable(LEVELEDSHE);
+
+    auto keys = cc->KeyGen();
+    ThreadPool pool(numThreads);
+
+    SAEncoder encoder(cc, batchSize);
+    std::vector<Ciphertext<DCRTPoly>> distinct(DISTINCTCIPHERTEXTS);
+    pool.ParallelFor(0, distinct.size(), [&](size_t i) {
+        distinct[i] = cc->Encrypt(keys.publicKey, encoder.Encode(static_cast<int64_t>(i % 8)));
+    });
+
+    Aggregator aggregator(cc, &pool);
+
+    std::cout << "Ring dimension: " << cc->GetRingDimension() << ", worker threads: " << pool.Size() << std::endl;
+    std::cout << "parties\tlinear_ms\ttree_ms\tspeedup\tmax_abs_diff" << std::endl;
+
+    for (size_t numParties : {5, 10, 50, 100, 500, 1000, 5000, 10000}) {
+        if (numParties > maxParties) {
+            break;
+        }
+        std::vector<Ciphertext<DCRTPoly>> ciphertexts(numParties);
+        for (size_t i = 0; i < numParties; ++i) {
+            ciphertexts[i] = distinct[i % distinct.size()];
+        }
+
+        Ciphertext<DCRTPoly> linearSum, treeSum;
+        std::vector<double> linearMs, treeMs;
+        for (int r = 0; r < REPETITIONS; ++r) {
+            linearMs.push_back(TimeMs([&] { linearSum = aggregator.AggregateLinear(ciphertexts); }));
+            treeMs.push_back(TimeMs([&] { treeSum = aggregator.AggregateTree(ciphertexts); }));
+        }
+
+        Plaintext linearResult, treeResult;
+        cc->Decrypt(linearSum, keys.secretKey, &linearResult);
+        cc->Decrypt(treeSum, keys.secretKey, &treeResult);
+        double diff = std::abs(linearResult->GetRealPackedValue()[0] - treeResult->GetRealPackedValue()[0]);
+
+        double linear = MedianMs(linearMs);
+        double tree   = MedianMs(treeMs);
+        std::cout << numParties << "\t" << linear << "\t" << tree << "\t" << linear / tree << "\t" << diff << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,96 @@
+#include "openfhe.h"
+
+#include "pipeline.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <utility>
+
+using namespace lbcrypto;
+
+// Threshold check with the ReLU series ("max"), the composite sign
+// polynomial ("sign") and CKKS to FHEW scheme switching ("fhew"): derived
+// depth, ring dimension, evaluation time and wrong decisions over all integer
+// pairs (x, threshold) in [0, upper-bound]. Every slot holds one x; a decision
+// is wrong if SchemeSwitchPipeline::IsAboveThreshold disagrees with
+// x > threshold. The margin column is the smallest |result| of "sign" and
+// "fhew" on the right side of zero. "fhew" compares
+// all slots and, for the latency of a single aggregate, only the first one.
+//
+// usage: bench_comparison [upper-bound] [sign-iterations]
+
+double MedianMs(std::vector<double> samples) {
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+template <typename F>
+double TimeMs(F&& f) {
+    auto start = std::chrono::high_resolution_clock::now();
+    f();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    int64_t upperBound      = (argc > 1) ? std::strtol(argv[1], nullptr, 10) : 40;
+    uint32_t signIterations = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 1;
+
+    const int64_t allSlots = upperBound + 1;
+    const std::vector<std::pair<std::string, int64_t>> runs = {
+        {"max", allSlots}, {"sign", allSlots}, {"fhew", allSlots}, {"fhew", 1}};
+
+    std::cout << "kernel\tslots\tdepth\tring_dim\teval_ms\twrong\tmargin" << std::endl;
+    for (const auto& [kernel, slots] : runs) {
+        PipelineParams params;
+        params.numParties     = 2;
+        params.batchSize      = 1;
+        params.upperBound     = upperBound;
+        params.comparison     = kernel;
+        params.signIterations = signIterations;
+        // "fhew" compares the leading metricsPerParty slots
+        params.metricsPerParty = slots;
+        // the benchmark's own dealer forms the joint secret for the switching keys
+        params.dealerSchemeSwitching = (kernel == "fhew");
+        while (params.batchSize < upperBound + 1) {
+            params.batchSize *= 2;
+        }
+
+        SchemeSwitchPipeline pipeline(params);
+        pipeline.Setup();
+        // keeps the eval-mult key generation out of the first threshold's timing
+        pipeline.GenerateEvalKeys();
+        const CryptoContext<DCRTPoly>& cc = pipeline.GetCryptoContext();
+
+        std::vector<double> xs(params.batchSize, 0);
+        for (int64_t x = 0; x <= upperBound; ++x) {
+            xs[x] = x;
+        }
+        auto ciphertext = cc->Encrypt(pipeline.GetJointPublicKey(), cc->MakeCKKSPackedPlaintext(xs));
+
+        std::vector<double> evalMs;
+        size_t wrong  = 0;
+        double margin = INFINITY;
+        for (int64_t threshold = 0; threshold <= upperBound; ++threshold) {
+            Ciphertext<DCRTPoly> result;
+            evalMs.push_back(TimeMs([&] { result = pipeline.EvaluateThreshold(ciphertext, threshold); }));
+            auto values = pipeline.Decrypt(result)->GetRealPackedValue();
+            for (int64_t x = 0; x < slots; ++x) {
+                if (pipeline.IsAboveThreshold(values[x], threshold) != (x > threshold)) {
+                    ++wrong;
+                }
+                else if (kernel != "max") {
+                    margin = std::min(margin, std::abs(values[x]));
+                }
+            }
+        }
+
+        std::cout << kernel << "\t" << slots << "\t" << pipeline.GetParams().multDepth << "\t"
+                  << cc->GetRingDimension() << "\t" << MedianMs(evalMs) << "\t" << wrong << "\t"
+                  << ((kernel != "max") ? margin : NAN) << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,81 @@
+#include "openfhe.h"
+
+#include "pipeline.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+
+using namespace lbcrypto;
+
+// One threshold decryption call per result ciphertext vs. one batched call.
+//
+// usage: bench_decryption [parties] [max-ciphertexts] [threads]
+
+const int REPETITIONS = 3;
+
+double MedianMs(std::vector<double> samples) {
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+template <typename F>
+double TimeMs(F&& f) {
+    auto start = std::chrono::high_resolution_clock::now();
+    f();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    PipelineParams params;
+    params.numParties     = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 5;
+    size_t maxCiphertexts = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 256;
+    params.numThreads     = (argc > 3) ? std::strtoul(argv[3], nullptr, 10) : 0;
+
+    SchemeSwitchPipeline pipeline(params);
+    pipeline.Setup();
+
+    std::vector<int64_t> values(params.numParties);
+    for (usint i = 0; i < params.numParties; ++i) {
+        values[i] = i % 8;
+    }
+    pipeline.SetValues(values);
+    auto aggregate = pipeline.Aggregate(pipeline.EncryptAll());
+
+    std::cout << "Parties: " << params.numParties << ", worker threads: " << pipeline.GetThreadPool().Size()
+              << std::endl;
+    std::cout << "ciphertexts\tsingle_ms\tbatch_ms\tspeedup\tmax_abs_diff" << std::endl;
+
+    for (size_t numCiphertexts : {1, 4, 16, 64, 256, 1024}) {
+        if (numCiphertexts > maxCiphertexts) {
+            break;
+        }
+        // decryption cost does not depend on the payload, so the batch repeats one result
+        std::vector<Ciphertext<DCRTPoly>> ciphertexts(numCiphertexts, aggregate);
+
+        std::vector<Plaintext> single(numCiphertexts), batch;
+        std::vector<double> singleMs, batchMs;
+        for (int r = 0; r < REPETITIONS; ++r) {
+            singleMs.push_back(TimeMs([&] {
+                for (size_t c = 0; c < numCiphertexts; ++c) {
+                    single[c] = pipeline.Decrypt(ciphertexts[c]);
+                }
+            }));
+            batchMs.push_back(TimeMs([&] { batch = pipeline.DecryptBatch(ciphertexts); }));
+        }
+
+        double diff = 0;
+        for (size_t c = 0; c < numCiphertexts; ++c) {
+            diff = std::max(diff, std::abs(single[c]->GetRealPackedValue()[0] - batch[c]->GetRealPackedValue()[0]));
+        }
+
+        double singleTime = MedianMs(singleMs);
+        double batchTime  = MedianMs(batchMs);
+        std::cout << numCiphertexts << "\t" << singleTime << "\t" << batchTime << "\t" << singleTime / batchTime << "\t"
+                  << diff << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,123 @@
+#include "openfhe.h"
+
+#include "decryptor.h"
+#include "pipeline.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <thread>
+
+using namespace lbcrypto;
+
+// Decryption latency when the parties deliver their partial decryptions at
+// skewed times: fusing once all partials are in (barrier) vs. folding every
+// partial into a FusionAccumulator on arrival (incremental). Arrival delays are
+// log-normal; the tail column is the time from the last arrival to the plaintext.
+//
+// usage: bench_fusion [parties] [median-delay-ms] [sigma]
+
+const int REPETITIONS = 5;
+
+double MedianMs(std::vector<double> samples) {
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+using Clock = std::chrono::steady_clock;
+
+double MsBetween(Clock::time_point start, Clock::time_point end) {
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    PipelineParams params;
+    params.numParties    = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 16;
+    double medianDelayMs = (argc > 2) ? std::strtod(argv[2], nullptr) : 20;
+    double sigma         = (argc > 3) ? std::strtod(argv[3], nullptr) : 1.0;
+
+    SchemeSwitchPipeline pipeline(params);
+    pipeline.Setup();
+    const CryptoContext<DCRTPoly>& cc = pipeline.GetCryptoContext();
+
+    std::vector<int64_t> values(params.numParties, 1);
+    pipeline.SetValues(values);
+    auto aggregate = pipeline.Aggregate(pipeline.EncryptAll());
+
+    // the partials themselves are computed up front; only their delivery is simulated
+    const auto& parties = pipeline.GetParties();
+    std::vector<Ciphertext<DCRTPoly>> partials(parties.size());
+    pipeline.GetThreadPool().ParallelFor(0, parties.size(), [&](size_t i) {
+        partials[i] = (i == 0) ? cc->MultipartyDecryptLead({aggregate}, parties[i].GetSecretKey())[0] :
+                                 cc->MultipartyDecryptMain({aggregate}, parties[i].GetSecretKey())[0];
+    });
+
+    std::mt19937 rng(42);
+    std::lognormal_distribution<double> delayMs(std::log(medianDelayMs), sigma);
+
+    std::cout << "Parties: " << params.numParties << ", median delay " << medianDelayMs << " ms, sigma " << sigma
+              << std::endl;
+    std::cout << "mode\tlatency_ms\ttail_ms\tresult" << std::endl;
+
+    std::vector<double> barrierLatency, barrierTail, incrementalLatency, incrementalTail;
+    double barrierResult = 0, incrementalResult = 0;
+    for (int r = 0; r < REPETITIONS; ++r) {
+        std::vector<std::chrono::microseconds> delays(parties.size());
+        for (auto& delay : delays) {
+            delay = std::chrono::microseconds(static_cast<int64_t>(1000 * delayMs(rng)));
+        }
+        const auto lastDelay = *std::max_element(delays.begin(), delays.end());
+
+        // barrier: collect everything, then MultipartyDecryptFusion
+        {
+            std::vector<Ciphertext<DCRTPoly>> received(parties.size());
+            auto start = Clock::now();
+            std::vector<std::thread> senders;
+            for (size_t i = 0; i < parties.size(); ++i) {
+                senders.emplace_back([&, i] {
+                    std::this_thread::sleep_until(start + delays[i]);
+                    received[i] = partials[i];
+                });
+            }
+            for (auto& sender : senders) {
+                sender.join();
+            }
+            Plaintext result;
+            cc->MultipartyDecryptFusion(received, &result);
+            auto end = Clock::now();
+            barrierLatency.push_back(MsBetween(start, end));
+            barrierTail.push_back(MsBetween(start + lastDelay, end));
+            barrierResult = result->GetRealPackedValue()[0];
+        }
+
+        // incremental: fold every partial on arrival
+        {
+            FusionAccumulator accumulator(cc, parties.size());
+            auto start = Clock::now();
+            std::vector<std::thread> senders;
+            for (size_t i = 0; i < parties.size(); ++i) {
+                senders.emplace_back([&, i] {
+                    std::this_thread::sleep_until(start + delays[i]);
+                    accumulator.Add(partials[i]);
+                });
+            }
+            for (auto& sender : senders) {
+                sender.join();
+            }
+            Plaintext result = accumulator.Finalize();
+            auto end         = Clock::now();
+            incrementalLatency.push_back(MsBetween(start, end));
+            incrementalTail.push_back(MsBetween(start + lastDelay, end));
+            incrementalResult = result->GetRealPackedValue()[0];
+        }
+    }
+
+    std::cout << "barrier\t" << MedianMs(barrierLatency) << "\t" << MedianMs(barrierTail) << "\t" << barrierResult
+              << std::endl;
+    std::cout << "incremental\t" << MedianMs(incrementalLatency) << "\t" << MedianMs(incrementalTail) << "\t"
+              << incrementalResult << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,89 @@
+#include "openfhe.h"
+
+#include "pipeline.h"
+
+// header files needed for serialization
+#include "ciphertext-ser.h"
+#include "scheme/bfvrns/bfvrns-ser.h"
+#include "scheme/bgvrns/bgvrns-ser.h"
+#include "scheme/ckksrns/ckksrns-ser.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+
+using namespace lbcrypto;
+
+// Pure summation on CKKS (with the depth the default threshold check needs)
+// vs. BGV and BFV with a plaintext modulus sized to parties * max-value:
+// ring dimension, modulus size, ciphertext bytes, encryption, aggregation and
+// decryption time, and the absolute error of the decrypted sum.
+//
+// usage: bench_integer_aggregation [parties] [max-value]
+
+const int REPETITIONS = 3;
+
+double MedianMs(std::vector<double> samples) {
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+template <typename F>
+double TimeMs(F&& f) {
+    auto start = std::chrono::high_resolution_clock::now();
+    f();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    usint numParties = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 16;
+    int64_t maxValue = (argc > 2) ? std::strtoll(argv[2], nullptr, 10) : 8;
+
+    std::vector<int64_t> values(numParties);
+    int64_t sum = 0;
+    for (usint i = 0; i < numParties; ++i) {
+        values[i] = (i * 7 + 3) % (maxValue + 1);
+        sum += values[i];
+    }
+
+    std::cout << "Parties: " << numParties << ", values up to " << maxValue << ", sum " << sum << std::endl;
+    std::cout << "scheme\tring_dim\tlog2_q\tplain_mod\tct_bytes\tencrypt_ms\taggregate_ms\tdecrypt_ms\tabs_error"
+              << std::endl;
+    for (const std::string scheme : {"ckks", "bgv", "bfv"}) {
+        PipelineParams params;
+        params.scheme     = scheme;
+        params.numParties = numParties;
+        params.maxValue   = maxValue;
+        params.upperBound = double(maxValue) * numParties;
+
+        SchemeSwitchPipeline pipeline(params);
+        pipeline.Setup();
+        pipeline.SetValues(values);
+        const CryptoContext<DCRTPoly>& cc = pipeline.GetCryptoContext();
+
+        std::vector<double> encryptMs, aggregateMs, decryptMs;
+        std::vector<Ciphertext<DCRTPoly>> ciphertexts;
+        Ciphertext<DCRTPoly> aggregate;
+        Plaintext result;
+        for (int r = 0; r < REPETITIONS; ++r) {
+            encryptMs.push_back(TimeMs([&] { ciphertexts = pipeline.EncryptAll(); }));
+            aggregateMs.push_back(TimeMs([&] { aggregate = pipeline.Aggregate(ciphertexts); }));
+            decryptMs.push_back(TimeMs([&] { result = pipeline.Decrypt(aggregate); }));
+        }
+
+        std::ostringstream os;
+        Serial::Serialize(ciphertexts[0], os, SerType::BINARY);
+        double decrypted = (scheme == "ckks") ? result->GetRealPackedValue()[0] : result->GetPackedValue()[0];
+
+        std::cout << scheme << "\t" << cc->GetRingDimension() << "\t"
+                  << std::log2(cc->GetCryptoParameters()->GetElementParams()->GetModulus().ConvertToDouble()) << "\t"
+                  << cc->GetCryptoParameters()->GetPlaintextModulus() << "\t" << os.str().size() << "\t"
+                  << MedianMs(encryptMs) << "\t" << MedianMs(aggregateMs) << "\t" << MedianMs(decryptMs) << "\t"
+                  << std::abs(decrypted - sum) << std::endl;
+    }
+
+    return 0;
+}
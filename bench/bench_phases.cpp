@@ -0,0 +1,270 @@
+#include "openfhe.h"
+
+#include "compactciphertext.h"
+#include "decryptor.h"
+#include "memoryreport.h"
+#include "pipeline.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+using namespace lbcrypto;
+
+// Per-phase timing of the whole SA to FHE conversion, swept over party count,
+// ring dimension, depth and worker threads: context generation, key ceremony,
+// SA encoding, encryption, serialization, aggregation, Chebyshev evaluation,
+// partial decryption, fusion and RecoverSharedKey (Chebyshev evaluation is
+// the sign kernel for depths below 4). Every configuration runs
+// repetitions times; the median and p95 per phase are printed and written to
+// a JSON file together with the raw samples, the peak RSS during the phase
+// (largest over the repetitions) and the sizes of the key and ciphertext
+// classes (see MemoryReport). Configurations OpenFHE rejects
+// (e.g. a ring dimension too small for the depth at 128-bit security) are
+// reported as skipped.
+//
+// usage: bench_phases [parties=4,16] [ringdims=0] [depths=6] [threads=1,0]
+//                     [repetitions=5] [output=bench_phases.json]
+//        ringdim 0 lets OpenFHE choose, threads 0 uses all hardware threads
+
+using Clock = std::chrono::steady_clock;
+
+const std::vector<std::string> PHASES = {"context",   "key_ceremony", "encode",         "encrypt", "serialize",
+                                         "aggregate", "chebyshev",    "partial_decrypt", "fusion", "recover_key"};
+
+std::vector<uint32_t> ParseList(const std::string& list) {
+    std::vector<uint32_t> values;
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        values.push_back(std::strtoul(item.c_str(), nullptr, 10));
+    }
+    return values;
+}
+
+double Percentile(std::vector<double> samples, double p) {
+    std::sort(samples.begin(), samples.end());
+    size_t rank = static_cast<size_t>(std::ceil(p / 100 * samples.size()));
+    return samples[std::min(samples.size(), std::max<size_t>(rank, 1)) - 1];
+}
+
+template <typename F>
+double TimeMs(F&& f) {
+    auto start = Clock::now();
+    f();
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// highest Chebyshev degree that fits into the depth; 0 if none does or if it
+// approximates ReLU on [-width, width] less accurately than EvalMax accepts
+uint32_t ChebyshevDegree(uint32_t multDepth, double width) {
+    uint32_t degree = 0;
+    for (uint32_t candidate : {5, 13, 27, 59, 119, 247}) {
+        if (ComparisonEngine::ChebyshevDepth(candidate) <= multDepth) {
+            degree = candidate;
+        }
+    }
+    if (degree > 0 && ComparisonEngine::ReluError(width, degree) > ComparisonEngine::MAX_RELU_ERROR) {
+        return 0;
+    }
+    return degree;
+}
+
+struct Config {
+    uint32_t parties;
+    uint32_t ringDim;
+    uint32_t depth;
+    uint32_t threads;
+};
+
+// phase -> one sample per repetition
+using Samples = std::map<std::string, std::vector<double>>;
+
+struct Result {
+    Samples samples;
+    std::map<std::string, uint64_t> peakRssBytes;
+    std::map<std::string, MemoryItem> memory;
+    // the ring dimension OpenFHE actually used
+    usint ringDim = 0;
+};
+
+Result RunConfig(const Config& config, int repetitions) {
+    PipelineParams params;
+    params.numParties = config.parties;
+    params.ringDim    = config.ringDim;
+    params.multDepth  = config.depth;
+    params.numThreads = config.threads;
+    params.upperBound = 8.0 * config.parties;
+    params.polyDegree = ChebyshevDegree(config.depth, params.upperBound - params.lowerBound);
+    if (params.polyDegree == 0) {
+        params.comparison     = "sign";
+        params.signIterations = 1;
+    }
+
+    SchemeSwitchPipeline pipeline(params);
+    ThreadPool& pool = pipeline.GetThreadPool();
+    std::vector<int64_t> values(config.parties);
+    for (uint32_t i = 0; i < config.parties; ++i) {
+        values[i] = i % 8;
+    }
+
+    Result result;
+    auto measure = [&](const std::string& phase, auto&& f) {
+        MemoryReport::ResetPeakRss();
+        result.samples[phase].push_back(TimeMs(f));
+        result.peakRssBytes[phase] = std::max(result.peakRssBytes[phase], MemoryReport::PeakRss());
+    };
+
+    MemoryReport::Global().Reset();
+    for (int r = 0; r < repetitions; ++r) {
+        CryptoContextImpl<DCRTPoly>::ClearEvalMultKeys();
+        CryptoContextImpl<DCRTPoly>::ClearEvalAutomorphismKeys();
+
+        measure("context", [&] { pipeline.GenerateContext(); });
+        measure("key_ceremony", [&] {
+            pipeline.GenerateKeys();
+            pipeline.GenerateEvalKeys();
+        });
+        pipeline.SetValues(values);
+        const CryptoContext<DCRTPoly>& cc = pipeline.GetCryptoContext();
+        const auto& parties               = pipeline.GetParties();
+
+        SAEncoder encoder(cc, params.batchSize);
+        measure("encode", [&] {
+            for (const Party& party : parties) {
+                party.Encode(encoder);
+            }
+        });
+
+        std::vector<Ciphertext<DCRTPoly>> ciphertexts;
+        measure("encrypt", [&] { ciphertexts = pipeline.EncryptAll(); });
+
+        measure("serialize", [&] {
+            for (const auto& ciphertext : ciphertexts) {
+                EncodeCiphertext(cc, ciphertext, false);
+            }
+        });
+
+        Ciphertext<DCRTPoly> aggregate;
+        measure("aggregate", [&] { aggregate = pipeline.Aggregate(ciphertexts); });
+
+        Ciphertext<DCRTPoly> thresholdResult;
+        measure("chebyshev", [&] { thresholdResult = pipeline.EvaluateThreshold(aggregate, params.upperBound / 2); });
+
+        std::vector<Ciphertext<DCRTPoly>> partials(parties.size());
+        measure("partial_decrypt", [&] {
+            pool.ParallelFor(0, parties.size(), [&](size_t i) {
+                const auto& sk = parties[i].GetSecretKey();
+                partials[i]    = (i == 0) ? cc->MultipartyDecryptLead({thresholdResult}, sk)[0] :
+                                            cc->MultipartyDecryptMain({thresholdResult}, sk)[0];
+            });
+        });
+
+        Plaintext plaintext;
+        measure("fusion", [&] { cc->MultipartyDecryptFusion(partials, &plaintext); });
+
+        const usint threshold = pipeline.GetThreshold();
+        auto shares           = cc->ShareKeys(parties[0].GetSecretKey(), config.parties, threshold, 1, "shamir");
+        Decryptor decryptor(cc, pool);
+        measure("recover_key", [&] { decryptor.RecoverKey(shares, config.parties, threshold, "shamir"); });
+
+        if (r == repetitions - 1) {
+            // sized outside the timed phases, as serializing the keys takes a while
+            MemoryReport& report = MemoryReport::Global();
+            report.Enable(true);
+            report.RecordKeyMaterial(cc, pipeline.GetJointPublicKey(), parties);
+            report.RecordCiphertext("party ciphertext", ciphertexts[0], ciphertexts.size());
+            report.RecordCiphertext("aggregate", aggregate, 1);
+            report.RecordCiphertext("threshold result", thresholdResult, 1);
+            report.RecordCiphertext("partial decryption", partials[0], partials.size());
+            report.Enable(false);
+        }
+    }
+    result.memory  = MemoryReport::Global().GetItems();
+    result.ringDim = pipeline.GetCryptoContext()->GetRingDimension();
+    return result;
+}
+
+int main(int argc, char* argv[]) {
+    std::map<std::string, std::string> args = {{"parties", "4,16"}, {"ringdims", "0"},
+                                               {"depths", "6"},     {"threads", "1,0"},
+                                               {"repetitions", "5"}, {"output", "bench_phases.json"}};
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        size_t eq       = arg.find('=');
+        if (eq == std::string::npos || args.count(arg.substr(0, eq)) == 0) {
+            std::cerr << "Unknown argument " << arg << std::endl;
+            return 1;
+        }
+        args[arg.substr(0, eq)] = arg.substr(eq + 1);
+    }
+    const int repetitions = std::max(1, std::atoi(args["repetitions"].c_str()));
+
+    std::ofstream json(args["output"]);
+    if (!json.is_open()) {
+        std::cerr << "Cannot write " << args["output"] << std::endl;
+        return 1;
+    }
+    json << "{\n  \"benchmark\": \"phases\",\n  \"repetitions\": " << repetitions << ",\n  \"results\": [";
+    // key and ciphertext sizes per configuration, written after the results
+    std::ostringstream memoryJson;
+
+    std::cout << "parties\tring_dim\tdepth\tthreads\tphase\tmedian_ms\tp95_ms\tpeak_rss_mb" << std::endl;
+    // the ring dimension columns hold the one OpenFHE used, not the requested one
+    bool first = true, firstMemory = true;
+    for (uint32_t parties : ParseList(args["parties"])) {
+        for (uint32_t ringDim : ParseList(args["ringdims"])) {
+            for (uint32_t depth : ParseList(args["depths"])) {
+                for (uint32_t threads : ParseList(args["threads"])) {
+                    Config config{parties, ringDim, depth, threads};
+                    Result result;
+                    try {
+                        result = RunConfig(config, repetitions);
+                    }
+                    catch (const std::exception& e) {
+                        std::cout << parties << "\t" << ringDim << "\t" << depth << "\t" << threads
+                                  << "\tskipped: " << e.what() << std::endl;
+                        continue;
+                    }
+
+                    for (const std::string& phase : PHASES) {
+                        const auto& phaseSamples = result.samples[phase];
+                        const double median      = Percentile(phaseSamples, 50);
+                        const double p95         = Percentile(phaseSamples, 95);
+                        const double peakRssMb   = result.peakRssBytes[phase] / (1024.0 * 1024.0);
+                        std::cout << parties << "\t" << result.ringDim << "\t" << depth << "\t" << threads << "\t"
+                                  << phase << "\t" << median << "\t" << p95 << "\t" << peakRssMb << std::endl;
+
+                        json << (first ? "\n" : ",\n") << "    {\"parties\": " << parties
+                             << ", \"ring_dim\": " << result.ringDim << ", \"depth\": " << depth
+                             << ", \"threads\": " << threads << ", \"phase\": \"" << phase
+                             << "\", \"median_ms\": " << median << ", \"p95_ms\": " << p95
+                             << ", \"peak_rss_mb\": " << peakRssMb << ", \"samples_ms\": [";
+                        for (size_t i = 0; i < phaseSamples.size(); ++i) {
+                            json << (i > 0 ? ", " : "") << phaseSamples[i];
+                        }
+                        json << "]}";
+                        first = false;
+                    }
+
+                    for (const auto& [name, item] : result.memory) {
+                        memoryJson << (firstMemory ? "\n" : ",\n") << "    {\"parties\": " << parties
+                                   << ", \"ring_dim\": " << result.ringDim << ", \"depth\": " << depth
+                                   << ", \"threads\": " << threads << ", \"class\": \"" << name << "\", \"count\": " << item.count
+                                   << ", \"serialized_bytes\": " << item.serializedBytes
+                                   << ", \"in_memory_bytes\": " << item.inMemoryBytes << "}";
+                        firstMemory = false;
+                    }
+                }
+            }
+        }
+    }
+    json << "\n  ],\n  \"memory\": [" << memoryJson.str() << "\n  ]\n}\n";
+
+    std::cout << "Results written to " << args["output"] << std::endl;
+    return 0;
+}
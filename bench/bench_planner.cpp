@@ -0,0 +1,39 @@
+#include "openfhe.h"
+
+#include "parameterplanner.h"
+
+#include <cstdlib>
+
+using namespace lbcrypto;
+
+// Parameters the planner picks for growing party counts and the validation
+// micro-benchmark of each plan: ring dimension, setup, threshold check and
+// decryption time, decision margin and correctness.
+//
+// usage: bench_planner [max-value] [precision] [max-parties]
+
+int main(int argc, char* argv[]) {
+    int64_t maxValue = (argc > 1) ? std::strtoll(argv[1], nullptr, 10) : 8;
+    double precision = (argc > 2) ? std::strtod(argv[2], nullptr) : 1;
+    usint maxParties = (argc > 3) ? std::strtoul(argv[3], nullptr, 10) : 64;
+
+    std::cout << "parties\tdepth\tscalemod\tkeyswitch\tring_dim\tsetup_ms\teval_ms\tdecrypt_ms\tmargin\tcorrect"
+              << std::endl;
+    for (usint numParties = 4; numParties <= maxParties; numParties *= 4) {
+        Workload workload;
+        workload.numParties = numParties;
+        workload.maxValue   = maxValue;
+        workload.precision  = precision;
+
+        ParameterPlanner planner(workload);
+        PipelineParams params     = planner.Plan();
+        PlanValidation validation = planner.Validate(params);
+
+        std::cout << numParties << "\t" << params.multDepth << "\t" << params.scalingModSize << "\t"
+                  << (params.keySwitchTechnique == BV ? "BV" : "HYBRID") << "\t" << validation.ringDim << "\t"
+                  << validation.setupMs << "\t" << validation.evalMs << "\t" << validation.decryptMs << "\t"
+                  << validation.margin << "\t" << validation.correct << std::endl;
+    }
+
+    return 0;
+}
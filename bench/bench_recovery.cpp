@@ -0,0 +1,75 @@
+#include "openfhe.h"
+
+#include "pipeline.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <random>
+
+using namespace lbcrypto;
+
+// Time to recover the secret keys of f simultaneously faulted parties (chosen
+// at random) for N parties, with "shamir" and "additive" sharing. Additive
+// sharing tolerates a single dropout only.
+//
+// usage: bench_recovery [max-parties] [threads]
+
+const int REPETITIONS = 3;
+
+double MedianMs(std::vector<double> samples) {
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+template <typename F>
+double TimeMs(F&& f) {
+    auto start = std::chrono::high_resolution_clock::now();
+    f();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    usint maxParties = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 50;
+    usint numThreads = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 0;
+
+    std::mt19937 rng(42);
+
+    std::cout << "share_type\tparties\tthreshold\tfailures\trecovery_ms" << std::endl;
+
+    for (const std::string shareType : {"shamir", "additive"}) {
+        for (usint numParties : {5, 10, 20, 50, 100}) {
+            if (numParties > maxParties) {
+                break;
+            }
+            PipelineParams params;
+            params.numParties    = numParties;
+            params.numThreads    = numThreads;
+            params.faultTolerant = true;
+            params.shareType     = shareType;
+
+            SchemeSwitchPipeline pipeline(params);
+            pipeline.Setup();
+
+            const usint maxFailures = pipeline.GetMaxRecoverable();
+            for (usint numFailures = 1; numFailures <= maxFailures; numFailures *= 2) {
+                std::vector<double> recoveryMs;
+                for (int r = 0; r < REPETITIONS; ++r) {
+                    std::vector<usint> indices(numParties);
+                    for (usint i = 0; i < numParties; ++i) {
+                        indices[i] = i;
+                    }
+                    std::shuffle(indices.begin(), indices.end(), rng);
+                    std::set<usint> faulted(indices.begin(), indices.begin() + numFailures);
+
+                    recoveryMs.push_back(TimeMs([&] { pipeline.RecoverKeys(faulted); }));
+                }
+                std::cout << shareType << "\t" << numParties << "\t" << pipeline.GetThreshold() << "\t" << numFailures
+                          << "\t" << MedianMs(recoveryMs) << std::endl;
+            }
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,88 @@
+#include "openfhe.h"
+
+#include "decryptioncoordinator.h"
+#include "pipeline.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <thread>
+
+using namespace lbcrypto;
+
+// Tail latency of threshold decryption with straggling parties, for several
+// coordinator deadlines. Every party answers after a log-normal delay; with
+// probability straggler-prob it straggles for 1 s instead, and with probability
+// dropout-prob it stays silent for 1 s and then reports failure.
+//
+// usage: bench_stragglers [parties] [decryptions] [straggler-prob] [dropout-prob]
+
+const std::chrono::milliseconds STRAGGLE(1000);
+
+int main(int argc, char* argv[]) {
+    PipelineParams params;
+    params.numParties     = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 7;
+    size_t numDecryptions = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 50;
+    double stragglerProb  = (argc > 3) ? std::strtod(argv[3], nullptr) : 0.05;
+    double dropoutProb    = (argc > 4) ? std::strtod(argv[4], nullptr) : 0.02;
+    params.faultTolerant  = true;
+    // the simulated parties sleep on pool workers, stragglers of earlier rounds
+    // for up to STRAGGLE; spare workers keep the recoveries from queueing behind them
+    params.numThreads = 4 * params.numParties;
+
+    SchemeSwitchPipeline pipeline(params);
+    pipeline.Setup();
+
+    std::vector<int64_t> values(params.numParties, 1);
+    pipeline.SetValues(values);
+    auto aggregate = pipeline.Aggregate(pipeline.EncryptAll());
+
+    auto local = DecryptionCoordinator::LocalSource(pipeline);
+
+    std::cout << "Parties: " << params.numParties << ", recoverable: " << pipeline.GetMaxRecoverable()
+              << ", straggler probability " << stragglerProb << ", dropout probability " << dropoutProb << std::endl;
+    std::cout << "deadline_ms\tp50_ms\tp90_ms\tp99_ms\tmax_ms\tspeculations\trecovered_partials\tfailed" << std::endl;
+
+    for (int deadlineMs : {10, 50, 200, 100000}) {
+        std::mt19937 rng(42);
+        std::lognormal_distribution<double> delayMs(std::log(5.0), 0.5);
+        std::uniform_real_distribution<double> coin(0, 1);
+
+        size_t failed = 0;
+        DecryptionCoordinator coordinator(pipeline, std::chrono::milliseconds(deadlineMs));
+        for (size_t d = 0; d < numDecryptions; ++d) {
+            // draw this round's behaviour up front so that every deadline sees the same rounds
+            std::vector<std::chrono::microseconds> delays(params.numParties);
+            std::vector<bool> drops(params.numParties);
+            for (usint i = 0; i < params.numParties; ++i) {
+                double c  = coin(rng);
+                drops[i]  = c < dropoutProb;
+                delays[i] = (c < dropoutProb + stragglerProb) ?
+                                std::chrono::microseconds(STRAGGLE) :
+                                std::chrono::microseconds(static_cast<int64_t>(1000 * delayMs(rng)));
+            }
+
+            auto source = [&local, delays, drops](usint party, const Ciphertext<DCRTPoly>& ct) {
+                std::this_thread::sleep_for(delays[party]);
+                if (drops[party]) {
+                    throw std::runtime_error("party dropped out");
+                }
+                return local(party, ct);
+            };
+            try {
+                coordinator.Decrypt(aggregate, source);
+            }
+            catch (const std::exception&) {
+                ++failed;
+            }
+        }
+
+        LatencyStats stats = coordinator.GetStats();
+        std::cout << deadlineMs << "\t" << stats.Percentile(50) << "\t" << stats.Percentile(90) << "\t"
+                  << stats.Percentile(99) << "\t" << stats.Percentile(100) << "\t" << stats.speculativeRecoveries
+                  << "\t" << stats.recoveredPartials << "\t" << failed << std::endl;
+    }
+
+    return 0;
+}
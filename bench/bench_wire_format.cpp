@@ -0,0 +1,112 @@
+#include "openfhe.h"
+
+#include "compactciphertext.h"
+#include "comparisonengine.h"
+#include "encoder.h"
+
+// header files needed for serialization
+#include "ciphertext-ser.h"
+#include "scheme/ckksrns/ckksrns-ser.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+
+using namespace lbcrypto;
+
+// Size and encode/decode time of the OpenFHE binary serialization vs. the
+// compact wire format, at full level and after dropping the levels a degree
+// polyDegree Chebyshev evaluation does not need.
+//
+// usage: bench_wire_format [mult-depth] [poly-degree]
+
+const int REPETITIONS = 5;
+
+double MedianMs(std::vector<double> samples) {
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+template <typename F>
+double TimeMs(F&& f) {
+    auto start = std::chrono::high_resolution_clock::now();
+    f();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    uint32_t multDepth  = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 6;
+    uint32_t polyDegree = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 27;
+
+    usint batchSize = 16;
+    CCParams<CryptoContextCKKSRNS> parameters;
+    parameters.SetSecurityLevel(HEStd_128_classic);
+    parameters.SetMultiplicativeDepth(multDepth);
+    parameters.SetScalingModSize(50);
+    parameters.SetBatchSize(batchSize);
+
+    CryptoContext<DCRTPoly> cc = GenCryptoContext(parameters);
+    cc->Enable(PKE);
+    cc->Enable(KEYSWITCH);
+    cc->Enable(LEVELEDSHE);
+
+    auto keys = cc->KeyGen();
+    SAEncoder encoder(cc, batchSize);
+    auto ciphertext = cc->Encrypt(keys.publicKey, encoder.Encode(int64_t(5)));
+
+    CompactCodec codec(cc);
+    const uint32_t levelsToDrop = CompactCodec::LevelsToDrop(multDepth, ComparisonEngine::ChebyshevDepth(polyDegree));
+
+    std::cout << "Ring dimension: " << cc->GetRingDimension() << ", depth " << multDepth << ", Chebyshev degree "
+              << polyDegree << " (" << levelsToDrop << " levels dropped)" << std::endl;
+    std::cout << "format\tbytes\tencode_ms\tdecode_ms\tabs_error" << std::endl;
+
+    auto report = [&](const std::string& name, const std::string& bytes, const std::vector<double>& encodeMs,
+                      const std::vector<double>& decodeMs, const Ciphertext<DCRTPoly>& decoded) {
+        Plaintext result;
+        cc->Decrypt(decoded, keys.secretKey, &result);
+        double error = std::abs(result->GetRealPackedValue()[0] - 5);
+        std::cout << name << "\t" << bytes.size() << "\t" << MedianMs(encodeMs) << "\t" << MedianMs(decodeMs) << "\t"
+                  << error << std::endl;
+    };
+
+    {
+        std::string bytes;
+        Ciphertext<DCRTPoly> decoded;
+        std::vector<double> encodeMs, decodeMs;
+        for (int r = 0; r < REPETITIONS; ++r) {
+            encodeMs.push_back(TimeMs([&] {
+                std::ostringstream os;
+                Serial::Serialize(ciphertext, os, SerType::BINARY);
+                bytes = os.str();
+            }));
+            decodeMs.push_back(TimeMs([&] {
+                std::istringstream is(bytes);
+                Serial::Deserialize(decoded, is, SerType::BINARY);
+            }));
+        }
+        report("binary", bytes, encodeMs, decodeMs, decoded);
+    }
+
+    for (uint32_t drop : {uint32_t(0), levelsToDrop}) {
+        std::string bytes;
+        Ciphertext<DCRTPoly> decoded;
+        std::vector<double> encodeMs, decodeMs;
+        // the level reduction is part of the encoding
+        for (int r = 0; r < REPETITIONS; ++r) {
+            encodeMs.push_back(TimeMs([&] {
+                bytes = codec.Export((drop > 0) ? cc->LevelReduce(ciphertext, nullptr, drop) : ciphertext);
+            }));
+            decodeMs.push_back(TimeMs([&] { decoded = codec.Import(bytes); }));
+        }
+        report("compact-drop" + std::to_string(drop), bytes, encodeMs, decodeMs, decoded);
+        if (levelsToDrop == 0) {
+            break;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,295 @@
+#include "ciphertextcontainer.h"
+#include "compactciphertext.h"
+#include "tracer.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+
+namespace {
+
+const char MAGIC[4]       = {'S', 'S', 'C', 'T'};
+const char INDEX_MAGIC[4] = {'S', 'S', 'C', 'I'};
+
+const uint32_t RECORD_CHUNK = 1;
+const uint32_t INDEX_CHUNK  = 2;
+
+const uint32_t COMPACT_FLAG = 1;
+
+// magic, version, context id
+const size_t HEADER_SIZE = 4 + 4 + 8;
+// type, payload length
+const size_t CHUNK_HEADER_SIZE = 4 + 8;
+// party id, level, flags
+const size_t RECORD_HEADER_SIZE = 4 + 4 + 4;
+// party id, level, flags, offset, size
+const size_t INDEX_ENTRY_SIZE = 4 + 4 + 4 + 8 + 8;
+// index chunk offset, index magic
+const size_t FOOTER_SIZE = 8 + 4;
+
+template <typename T>
+void Put(std::string& out, T value) {
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    out.append(bytes, sizeof(T));
+}
+
+template <typename T>
+T Get(const char* data) {
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+void ThrowErrno(const std::string& what, const std::string& path) {
+    OPENFHE_THROW(openfhe_error, "Error " + what + " container " + path + ": " + std::strerror(errno));
+}
+
+void WriteFully(int fd, const char* buffer, size_t size, const std::string& path) {
+    size_t done = 0;
+    while (done < size) {
+        ssize_t n = ::write(fd, buffer + done, size - done);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            ThrowErrno("writing", path);
+        }
+        done += static_cast<size_t>(n);
+    }
+}
+
+uint64_t Fnv1a(uint64_t hash, std::string_view bytes) {
+    for (char c : bytes) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+double MsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+}  // namespace
+
+ContainerWriter::ContainerWriter(const std::string& path, uint64_t contextId, bool sync) : path(path), sync(sync) {
+    fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        ThrowErrno("creating", path);
+    }
+    std::string header(MAGIC, sizeof(MAGIC));
+    Put<uint32_t>(header, VERSION);
+    Put<uint64_t>(header, contextId);
+    WriteFully(fd, header.data(), header.size(), path);
+    offset = header.size();
+}
+
+ContainerWriter::~ContainerWriter() {
+    try {
+        if (uncommitted > 0) {
+            Commit();
+        }
+    }
+    catch (...) {
+    }
+    ::close(fd);
+}
+
+uint64_t ContainerWriter::ContextId(const CryptoContext<DCRTPoly>& cc, const std::string& keyTag) {
+    uint64_t hash = Fnv1a(14695981039346656037ULL, keyTag);
+    hash          = Fnv1a(hash, std::to_string(cc->GetRingDimension()));
+    return Fnv1a(hash, cc->GetCryptoParameters()->GetElementParams()->GetModulus().ToString());
+}
+
+void ContainerWriter::WriteChunk(uint32_t type, std::string_view header, std::string_view payload) {
+    std::string chunkHeader;
+    Put<uint32_t>(chunkHeader, type);
+    Put<uint64_t>(chunkHeader, header.size() + payload.size());
+    chunkHeader.append(header);
+    WriteFully(fd, chunkHeader.data(), chunkHeader.size(), path);
+    WriteFully(fd, payload.data(), payload.size(), path);
+    offset += chunkHeader.size() + payload.size();
+}
+
+void ContainerWriter::Append(uint32_t partyId, uint32_t level, bool compact, std::string_view bytes) {
+    std::string recordHeader;
+    Put<uint32_t>(recordHeader, partyId);
+    Put<uint32_t>(recordHeader, level);
+    Put<uint32_t>(recordHeader, compact ? COMPACT_FLAG : 0);
+
+    std::lock_guard<std::mutex> lock(mtx);
+    ContainerEntry entry;
+    entry.partyId = partyId;
+    entry.level   = level;
+    entry.compact = compact;
+    entry.offset  = offset + CHUNK_HEADER_SIZE + RECORD_HEADER_SIZE;
+    entry.size    = bytes.size();
+    WriteChunk(RECORD_CHUNK, recordHeader, bytes);
+    entries.push_back(entry);
+    ++uncommitted;
+}
+
+void ContainerWriter::Commit() {
+    std::lock_guard<std::mutex> lock(mtx);
+    const uint64_t indexOffset = offset;
+
+    std::string index;
+    Put<uint64_t>(index, entries.size());
+    for (const auto& entry : entries) {
+        Put<uint32_t>(index, entry.partyId);
+        Put<uint32_t>(index, entry.level);
+        Put<uint32_t>(index, entry.compact ? COMPACT_FLAG : 0);
+        Put<uint64_t>(index, entry.offset);
+        Put<uint64_t>(index, entry.size);
+    }
+    Put<uint64_t>(index, indexOffset);
+    index.append(INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    WriteChunk(INDEX_CHUNK, {}, index);
+
+    if (sync && ::fsync(fd) != 0) {
+        ThrowErrno("syncing", path);
+    }
+    uncommitted = 0;
+}
+
+ContainerReader::ContainerReader(const std::string& path) : path(path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        ThrowErrno("opening", path);
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        ThrowErrno("reading", path);
+    }
+    size = static_cast<size_t>(st.st_size);
+    if (size < HEADER_SIZE) {
+        ::close(fd);
+        OPENFHE_THROW(openfhe_error, "Not a ciphertext container: " + path);
+    }
+    void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        ThrowErrno("mapping", path);
+    }
+    data = static_cast<const char*>(mapping);
+
+    if (std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0 || Get<uint32_t>(data + 4) != ContainerWriter::VERSION) {
+        ::munmap(const_cast<char*>(data), size);
+        OPENFHE_THROW(openfhe_error, "Not a ciphertext container of version " +
+                                         std::to_string(ContainerWriter::VERSION) + ": " + path);
+    }
+    contextId = Get<uint64_t>(data + 8);
+
+    if (!ReadIndex()) {
+        ScanRecords();
+    }
+}
+
+ContainerReader::~ContainerReader() {
+    ::munmap(const_cast<char*>(data), size);
+}
+
+bool ContainerReader::ReadIndex() {
+    if (size < HEADER_SIZE + CHUNK_HEADER_SIZE + 8 + FOOTER_SIZE ||
+        std::memcmp(data + size - sizeof(INDEX_MAGIC), INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0) {
+        return false;
+    }
+    // the index chunk is its header, the entry count, the entries and the footer;
+    // the bounds are checked by subtraction so that a corrupt offset or count cannot wrap
+    const size_t indexFixedSize = CHUNK_HEADER_SIZE + 8 + FOOTER_SIZE;
+    const uint64_t indexOffset  = Get<uint64_t>(data + size - FOOTER_SIZE);
+    if (indexOffset < HEADER_SIZE || indexOffset > size - indexFixedSize ||
+        Get<uint32_t>(data + indexOffset) != INDEX_CHUNK) {
+        return false;
+    }
+    const char* p        = data + indexOffset + CHUNK_HEADER_SIZE;
+    const uint64_t count = Get<uint64_t>(p);
+    if (count > (size - indexOffset - indexFixedSize) / INDEX_ENTRY_SIZE) {
+        return false;
+    }
+    p += 8;
+
+    std::vector<ContainerEntry> index(count);
+    for (auto& entry : index) {
+        entry.partyId = Get<uint32_t>(p);
+        entry.level   = Get<uint32_t>(p + 4);
+        entry.compact = (Get<uint32_t>(p + 8) & COMPACT_FLAG) != 0;
+        entry.offset  = Get<uint64_t>(p + 12);
+        entry.size    = Get<uint64_t>(p + 20);
+        if (entry.offset > indexOffset || entry.size > indexOffset - entry.offset) {
+            return false;
+        }
+        p += INDEX_ENTRY_SIZE;
+    }
+    entries = std::move(index);
+    return true;
+}
+
+void ContainerReader::ScanRecords() {
+    size_t pos = HEADER_SIZE;
+    while (pos + CHUNK_HEADER_SIZE <= size) {
+        const uint32_t type    = Get<uint32_t>(data + pos);
+        const uint64_t payload = Get<uint64_t>(data + pos + 4);
+        if (payload > size - pos - CHUNK_HEADER_SIZE) {
+            // the writer was interrupted inside this chunk
+            break;
+        }
+        if (type == RECORD_CHUNK && payload >= RECORD_HEADER_SIZE) {
+            const char* p = data + pos + CHUNK_HEADER_SIZE;
+            ContainerEntry entry;
+            entry.partyId = Get<uint32_t>(p);
+            entry.level   = Get<uint32_t>(p + 4);
+            entry.compact = (Get<uint32_t>(p + 8) & COMPACT_FLAG) != 0;
+            entry.offset  = pos + CHUNK_HEADER_SIZE + RECORD_HEADER_SIZE;
+            entry.size    = payload - RECORD_HEADER_SIZE;
+            entries.push_back(entry);
+        }
+        pos += CHUNK_HEADER_SIZE + payload;
+    }
+}
+
+std::string_view ContainerReader::GetBytes(size_t i) const {
+    const ContainerEntry& entry = entries.at(i);
+    return std::string_view(data + entry.offset, entry.size);
+}
+
+Ciphertext<DCRTPoly> ContainerReader::Load(const CryptoContext<DCRTPoly>& cc, const std::string& keyTag,
+                                           size_t i) const {
+    if (contextId != ContainerWriter::ContextId(cc, keyTag)) {
+        OPENFHE_THROW(openfhe_error, "Container " + path + " was written for another key set");
+    }
+    return DecodeCiphertext(cc, GetBytes(i));
+}
+
+ContainerSink::ContainerSink(const CryptoContext<DCRTPoly>& cc, const std::string& path, uint64_t contextId,
+                             bool compact, usint numWriters, bool sync)
+    : BackgroundSink(numWriters), cc(cc), compact(compact), container(path, contextId, sync) {}
+
+ContainerSink::~ContainerSink() {
+    WaitPending(false);
+}
+
+void ContainerSink::Write(usint index, const Ciphertext<DCRTPoly>& ct) {
+    Submit([this, index, ct] {
+        TraceScope scope("write_ciphertext", index + 1);
+        auto start         = std::chrono::steady_clock::now();
+        std::string bytes  = EncodeCiphertext(cc, ct, compact);
+        double serializeMs = MsSince(start);
+
+        start = std::chrono::steady_clock::now();
+        container.Append(index + 1, ct->GetLevel(), compact, bytes);
+        Record(bytes.size(), serializeMs, MsSince(start));
+    });
+}
+
+void ContainerSink::Flush() {
+    BackgroundSink::Flush();
+    container.Commit();
+}
@@ -0,0 +1,158 @@
+#ifndef OPENFHE_CIPHERTEXTCONTAINER_H
+#define OPENFHE_CIPHERTEXTCONTAINER_H
+
+#include "openfhe.h"
+
+#include "ciphertextsink.h"
+
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace lbcrypto;
+
+/**
+ * Location and metadata of one ciphertext in a container.
+ */
+struct ContainerEntry {
+    uint32_t partyId = 0;
+    uint32_t level   = 0;
+    // serialized with CompactCodec rather than Serial BINARY
+    bool compact = false;
+    // byte range of the serialized ciphertext within the file
+    uint64_t offset = 0;
+    uint64_t size   = 0;
+};
+
+/**
+ * Append-only file holding many serialized ciphertexts, e.g. all party
+ * ciphertexts of one epoch, instead of one file per party.
+ *
+ * Layout (little endian): "SSCT", version, 64-bit context id, then chunks of
+ * a 32-bit type, a 64-bit payload length and the payload:
+ *   record  party id, level, flags, serialized ciphertext
+ *   index   entry count, the ContainerEntry of every record so far, the
+ *           offset of the index chunk and "SSCI"
+ * Every Commit() appends an index chunk, so the last 12 bytes of a committed
+ * file locate the index. A file whose writer did not commit is still readable:
+ * the reader then scans the records and ignores a truncated last chunk.
+ */
+class ContainerWriter {
+public:
+    static constexpr uint32_t VERSION = 1;
+
+    /**
+     * Creates (or truncates) the file at path.
+     * @param contextId - see ContextId; checked by readers before decoding
+     * @param sync - fsync the file in Commit()
+     */
+    ContainerWriter(const std::string& path, uint64_t contextId, bool sync = true);
+
+    // commits pending records, discarding errors
+    ~ContainerWriter();
+
+    ContainerWriter(const ContainerWriter&)            = delete;
+    ContainerWriter& operator=(const ContainerWriter&) = delete;
+
+    /**
+     * Appends one serialized ciphertext. Thread safe.
+     */
+    void Append(uint32_t partyId, uint32_t level, bool compact, std::string_view bytes);
+
+    /**
+     * Appends the index of all records so far and syncs the file.
+     */
+    void Commit();
+
+    /**
+     * Identifies the key set the ciphertexts are encrypted under: a hash of the
+     * key tag, ring dimension and ciphertext modulus.
+     */
+    static uint64_t ContextId(const CryptoContext<DCRTPoly>& cc, const std::string& keyTag);
+
+private:
+    void WriteChunk(uint32_t type, std::string_view header, std::string_view payload);
+
+    std::string path;
+    bool sync;
+    int fd = -1;
+
+    std::mutex mtx;
+    uint64_t offset = 0;
+    std::vector<ContainerEntry> entries;
+    // records appended since the last Commit()
+    size_t uncommitted = 0;
+};
+
+/**
+ * Read-only, memory-mapped view of a container. GetBytes returns views into
+ * the mapping, so ciphertexts can be decoded in any order without copying the
+ * file. Safe to share between threads.
+ */
+class ContainerReader {
+public:
+    explicit ContainerReader(const std::string& path);
+
+    ~ContainerReader();
+
+    ContainerReader(const ContainerReader&)            = delete;
+    ContainerReader& operator=(const ContainerReader&) = delete;
+
+    uint64_t GetContextId() const {
+        return contextId;
+    }
+
+    size_t Size() const {
+        return entries.size();
+    }
+
+    const ContainerEntry& GetEntry(size_t i) const {
+        return entries.at(i);
+    }
+
+    /**
+     * Serialized ciphertext i; valid while the reader is alive.
+     */
+    std::string_view GetBytes(size_t i) const;
+
+    /**
+     * Decodes ciphertext i; throws openfhe_error if the container was written
+     * for another key set.
+     */
+    Ciphertext<DCRTPoly> Load(const CryptoContext<DCRTPoly>& cc, const std::string& keyTag, size_t i) const;
+
+private:
+    bool ReadIndex();
+
+    void ScanRecords();
+
+    std::string path;
+    const char* data = nullptr;
+    size_t size      = 0;
+    uint64_t contextId = 0;
+    std::vector<ContainerEntry> entries;
+};
+
+/**
+ * CiphertextSink appending to a single container file. Serialization runs on
+ * background writer threads; Flush() commits the index.
+ */
+class ContainerSink : public BackgroundSink {
+public:
+    ContainerSink(const CryptoContext<DCRTPoly>& cc, const std::string& path, uint64_t contextId,
+                  bool compact = false, usint numWriters = 1, bool sync = true);
+
+    ~ContainerSink() override;
+
+    void Write(usint index, const Ciphertext<DCRTPoly>& ct) override;
+
+    void Flush() override;
+
+private:
+    CryptoContext<DCRTPoly> cc;
+    bool compact;
+    ContainerWriter container;
+};
+
+#endif  //OPENFHE_CIPHERTEXTCONTAINER_H
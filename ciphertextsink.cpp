@@ -0,0 +1,144 @@
+#include "ciphertextsink.h"
+#include "compactciphertext.h"
+#include "tracer.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+double MsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void ThrowErrno(const std::string& what, const std::string& path) {
+    OPENFHE_THROW(openfhe_error, "Error " + what + " " + path + ": " + std::strerror(errno));
+}
+
+void WriteFileFully(const std::string& path, const std::string& bytes, bool sync) {
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        ThrowErrno("creating", path);
+    }
+    size_t done = 0;
+    while (done < bytes.size()) {
+        ssize_t n = ::write(fd, bytes.data() + done, bytes.size() - done);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            ::close(fd);
+            ThrowErrno("writing", path);
+        }
+        done += static_cast<size_t>(n);
+    }
+    if (sync && ::fsync(fd) != 0) {
+        ::close(fd);
+        ThrowErrno("syncing", path);
+    }
+    if (::close(fd) != 0) {
+        ThrowErrno("closing", path);
+    }
+}
+
+}  // namespace
+
+SinkStats CiphertextSink::GetStats() const {
+    std::lock_guard<std::mutex> lock(statsMtx);
+    return stats;
+}
+
+void CiphertextSink::Record(uint64_t bytes, double serializeMs, double writeMs) {
+    std::lock_guard<std::mutex> lock(statsMtx);
+    ++stats.ciphertexts;
+    stats.bytes += bytes;
+    stats.serializeMs += serializeMs;
+    stats.writeMs += writeMs;
+    stats.maxWriteMs = std::max(stats.maxWriteMs, serializeMs + writeMs);
+}
+
+BackgroundSink::BackgroundSink(usint numWriters) : writers(std::max<usint>(1, numWriters)) {}
+
+void BackgroundSink::Flush() {
+    WaitPending(true);
+}
+
+void BackgroundSink::Submit(std::function<void()> task) {
+    auto f = writers.Submit(std::move(task));
+    std::lock_guard<std::mutex> lock(mtx);
+    pending.push_back(std::move(f));
+}
+
+void BackgroundSink::WaitPending(bool rethrow) {
+    std::vector<std::future<void>> waiting;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        waiting.swap(pending);
+    }
+
+    std::exception_ptr firstError;
+    for (auto& f : waiting) {
+        try {
+            f.get();
+        }
+        catch (...) {
+            if (!firstError) {
+                firstError = std::current_exception();
+            }
+        }
+    }
+    if (firstError && rethrow) {
+        std::rethrow_exception(firstError);
+    }
+}
+
+FileSink::FileSink(const CryptoContext<DCRTPoly>& cc, const std::string& directory, bool compact, usint numWriters,
+                   bool sync)
+    : BackgroundSink(numWriters), cc(cc), directory(directory), compact(compact), sync(sync) {
+    std::error_code ec;
+    fs::create_directories(directory, ec);
+    if (ec) {
+        OPENFHE_THROW(openfhe_error, "Cannot create ciphertext directory " + directory + ": " + ec.message());
+    }
+}
+
+FileSink::~FileSink() {
+    WaitPending(false);
+}
+
+std::string FileSink::FileName(usint index, bool compact) {
+    std::string suffix = (index == 0) ? "" : std::to_string(index);
+    return "ciphertext" + suffix + (compact ? ".ssc" : ".txt");
+}
+
+void FileSink::Write(usint index, const Ciphertext<DCRTPoly>& ct) {
+    Submit([this, index, ct] { WriteFile(index, ct); });
+}
+
+void FileSink::WriteFile(usint index, const Ciphertext<DCRTPoly>& ct) {
+    TraceScope scope("write_ciphertext", index + 1);
+    auto start         = std::chrono::steady_clock::now();
+    std::string bytes  = EncodeCiphertext(cc, ct, compact);
+    double serializeMs = MsSince(start);
+
+    start                  = std::chrono::steady_clock::now();
+    const std::string name = FileName(index, compact);
+    const std::string path = directory + "/" + name;
+    // the leading dot keeps the partial file out of prefix-based directory scans
+    const std::string tmpPath = directory + "/." + name + ".tmp";
+    WriteFileFully(tmpPath, bytes, sync);
+    if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        ThrowErrno("renaming", tmpPath);
+    }
+
+    Record(bytes.size(), serializeMs, MsSince(start));
+}
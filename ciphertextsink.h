@@ -0,0 +1,120 @@
+#ifndef OPENFHE_CIPHERTEXTSINK_H
+#define OPENFHE_CIPHERTEXTSINK_H
+
+#include "openfhe.h"
+
+#include "threadpool.h"
+
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace lbcrypto;
+
+struct SinkStats {
+    size_t ciphertexts = 0;
+    uint64_t bytes     = 0;
+    // summed over all writes; writeMs includes the fsync
+    double serializeMs = 0;
+    double writeMs     = 0;
+    double maxWriteMs  = 0;
+
+    double MeanWriteMs() const {
+        return (ciphertexts == 0) ? 0 : (serializeMs + writeMs) / ciphertexts;
+    }
+};
+
+/**
+ * Destination of the parties' FHE ciphertexts. Write may return before the
+ * ciphertext is persisted, so that serialization and I/O overlap with the
+ * encryption of the next party; Flush waits for all pending writes.
+ */
+class CiphertextSink {
+public:
+    virtual ~CiphertextSink() = default;
+
+    /**
+     * Queues ct, the ciphertext of party index (0-based). Must be thread safe.
+     */
+    virtual void Write(usint index, const Ciphertext<DCRTPoly>& ct) = 0;
+
+    /**
+     * Blocks until every queued ciphertext is persisted and rethrows the first
+     * error raised while writing.
+     */
+    virtual void Flush() = 0;
+
+    SinkStats GetStats() const;
+
+protected:
+    void Record(uint64_t bytes, double serializeMs, double writeMs);
+
+private:
+    mutable std::mutex statsMtx;
+    SinkStats stats;
+};
+
+/**
+ * Base of sinks that serialize and write on a pool of background writer
+ * threads. Derived classes must call WaitPending() in their destructor, before
+ * the state their tasks use is destroyed.
+ */
+class BackgroundSink : public CiphertextSink {
+public:
+    void Flush() override;
+
+protected:
+    explicit BackgroundSink(usint numWriters);
+
+    void Submit(std::function<void()> task);
+
+    /**
+     * Blocks until all submitted tasks finished; rethrows the first error if rethrow is set.
+     */
+    void WaitPending(bool rethrow);
+
+private:
+    std::mutex mtx;
+    std::vector<std::future<void>> pending;
+    ThreadPool writers;
+};
+
+/**
+ * Writes every ciphertext to its own file in a directory, on a pool of
+ * background writer threads. Files are written under a hidden temporary name
+ * and renamed into place, so readers polling the directory (see
+ * StreamingAggregator::ConsumeDirectory) never see partial files.
+ */
+class FileSink : public BackgroundSink {
+public:
+    /**
+     * @param compact - write CompactCodec::Export output instead of Serial BINARY
+     * @param numWriters - background writer threads
+     * @param sync - fsync every file before renaming it into place
+     */
+    FileSink(const CryptoContext<DCRTPoly>& cc, const std::string& directory, bool compact = false,
+             usint numWriters = 1, bool sync = true);
+
+    // waits for the pending writes, discarding their errors
+    ~FileSink() override;
+
+    void Write(usint index, const Ciphertext<DCRTPoly>& ct) override;
+
+    /**
+     * File name of party index's ciphertext: ciphertext.txt, ciphertext1.txt,
+     * ciphertext2.txt, ... (".ssc" for the compact format).
+     */
+    static std::string FileName(usint index, bool compact);
+
+private:
+    void WriteFile(usint index, const Ciphertext<DCRTPoly>& ct);
+
+    CryptoContext<DCRTPoly> cc;
+    std::string directory;
+    bool compact;
+    bool sync;
+};
+
+#endif  //OPENFHE_CIPHERTEXTSINK_H
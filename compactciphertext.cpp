@@ -0,0 +1,267 @@
+#include "compactciphertext.h"
+#include "tracer.h"
+
+// header files needed for serialization
+#include "ciphertext-ser.h"
+#include "scheme/bfvrns/bfvrns-ser.h"
+#include "scheme/bgvrns/bgvrns-ser.h"
+#include "scheme/ckksrns/ckksrns-ser.h"
+
+#include <algorithm>
+#include <cstring>
+#include <istream>
+#include <sstream>
+#include <streambuf>
+
+namespace {
+
+const char MAGIC[4] = {'S', 'S', 'C', 'C'};
+
+template <typename T>
+void Put(std::string& out, T value) {
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    out.append(bytes, sizeof(T));
+}
+
+template <typename T>
+T Get(std::string_view in, size_t& pos) {
+    if (pos + sizeof(T) > in.size()) {
+        OPENFHE_THROW(openfhe_error, "Truncated compact ciphertext");
+    }
+    T value;
+    std::memcpy(&value, in.data() + pos, sizeof(T));
+    pos += sizeof(T);
+    return value;
+}
+
+uint32_t BitWidth(uint64_t modulus) {
+    uint32_t bits = 0;
+    while (bits < 64 && (modulus >> bits) != 0) {
+        ++bits;
+    }
+    return bits;
+}
+
+// LSB-first bit packing of values narrower than 64 bits
+class BitWriter {
+public:
+    explicit BitWriter(std::string& out) : out(out) {}
+
+    void Write(uint64_t value, uint32_t bits) {
+        while (bits > 0) {
+            uint32_t take = std::min<uint32_t>(bits, 8 - filled);
+            current |= static_cast<uint8_t>((value & ((uint64_t(1) << take) - 1)) << filled);
+            value >>= take;
+            bits -= take;
+            filled += take;
+            if (filled == 8) {
+                Flush();
+            }
+        }
+    }
+
+    void Flush() {
+        if (filled > 0) {
+            out.push_back(static_cast<char>(current));
+            current = 0;
+            filled  = 0;
+        }
+    }
+
+private:
+    std::string& out;
+    uint8_t current = 0;
+    uint32_t filled = 0;
+};
+
+class BitReader {
+public:
+    BitReader(std::string_view in, size_t pos) : in(in), pos(pos) {}
+
+    uint64_t Read(uint32_t bits) {
+        uint64_t value  = 0;
+        uint32_t offset = 0;
+        while (offset < bits) {
+            if (pos >= in.size()) {
+                OPENFHE_THROW(openfhe_error, "Truncated compact ciphertext");
+            }
+            uint32_t take = std::min<uint32_t>(bits - offset, 8 - used);
+            uint64_t part = (static_cast<uint8_t>(in[pos]) >> used) & ((1u << take) - 1);
+            value |= part << offset;
+            offset += take;
+            used += take;
+            if (used == 8) {
+                ++pos;
+                used = 0;
+            }
+        }
+        return value;
+    }
+
+private:
+    std::string_view in;
+    size_t pos;
+    uint32_t used = 0;
+};
+
+// read-only stream over bytes that are not copied
+class MemoryBuffer : public std::streambuf {
+public:
+    explicit MemoryBuffer(std::string_view bytes) {
+        char* begin = const_cast<char*>(bytes.data());
+        setg(begin, begin, begin + bytes.size());
+    }
+};
+
+}  // namespace
+
+std::string EncodeCiphertext(const CryptoContext<DCRTPoly>& cc, const Ciphertext<DCRTPoly>& ct, bool compact) {
+    TraceScope scope("serialize");
+    std::string bytes;
+    if (compact) {
+        bytes = CompactCodec(cc).Export(ct);
+    }
+    else {
+        std::ostringstream os;
+        Serial::Serialize(ct, os, SerType::BINARY);
+        bytes = os.str();
+    }
+    TraceCount("serialized_bytes", bytes.size());
+    return bytes;
+}
+
+Ciphertext<DCRTPoly> DecodeCiphertext(const CryptoContext<DCRTPoly>& cc, std::string_view bytes) {
+    TraceScope scope("deserialize");
+    TraceCount("deserialized_bytes", bytes.size());
+    if (CompactCodec::IsCompact(bytes)) {
+        return CompactCodec(cc).Import(bytes);
+    }
+    MemoryBuffer buffer(bytes);
+    std::istream is(&buffer);
+    Ciphertext<DCRTPoly> ciphertext;
+    Serial::Deserialize(ciphertext, is, SerType::BINARY);
+    return ciphertext;
+}
+
+CompactCodec::CompactCodec(const CryptoContext<DCRTPoly>& cc) : cc(cc) {}
+
+uint32_t CompactCodec::LevelsToDrop(uint32_t multDepth, uint32_t neededDepth) {
+    return (multDepth > neededDepth) ? multDepth - neededDepth : 0;
+}
+
+bool CompactCodec::IsCompact(std::string_view bytes) {
+    return bytes.size() >= sizeof(MAGIC) && std::memcmp(bytes.data(), MAGIC, sizeof(MAGIC)) == 0;
+}
+
+std::string CompactCodec::Export(const Ciphertext<DCRTPoly>& ct) const {
+    const auto& elements   = ct->GetElements();
+    const auto& towers     = elements[0].GetParams()->GetParams();
+    const uint32_t ringDim = elements[0].GetElementAtIndex(0).GetLength();
+
+    std::string out;
+    out.append(MAGIC, sizeof(MAGIC));
+    Put<uint32_t>(out, VERSION);
+    Put<uint32_t>(out, ct->GetLevel());
+    Put<uint32_t>(out, ct->GetNoiseScaleDeg());
+    Put<uint32_t>(out, ct->GetSlots());
+    Put<double>(out, ct->GetScalingFactor());
+    const std::string keyTag = ct->GetKeyTag();
+    Put<uint32_t>(out, keyTag.size());
+    out.append(keyTag);
+    Put<uint32_t>(out, elements.size());
+    Put<uint32_t>(out, towers.size());
+    Put<uint32_t>(out, ringDim);
+
+    std::vector<uint32_t> widths(towers.size());
+    for (size_t i = 0; i < towers.size(); ++i) {
+        widths[i] = BitWidth(towers[i]->GetModulus().ConvertToInt());
+        Put<uint8_t>(out, widths[i]);
+    }
+
+    BitWriter writer(out);
+    for (const auto& element : elements) {
+        if (element.GetFormat() != Format::EVALUATION) {
+            OPENFHE_THROW(openfhe_error, "Compact export expects ciphertexts in EVALUATION format");
+        }
+        for (size_t i = 0; i < towers.size(); ++i) {
+            const NativePoly& tower = element.GetElementAtIndex(i);
+            for (size_t j = 0; j < ringDim; ++j) {
+                writer.Write(tower[j].ConvertToInt(), widths[i]);
+            }
+        }
+    }
+    writer.Flush();
+
+    return out;
+}
+
+Ciphertext<DCRTPoly> CompactCodec::Import(std::string_view bytes) const {
+    if (!IsCompact(bytes)) {
+        OPENFHE_THROW(openfhe_error, "Not a compact ciphertext");
+    }
+    size_t pos = sizeof(MAGIC);
+    if (Get<uint32_t>(bytes, pos) != VERSION) {
+        OPENFHE_THROW(openfhe_error, "Unsupported compact ciphertext version");
+    }
+    uint32_t level         = Get<uint32_t>(bytes, pos);
+    uint32_t noiseScaleDeg = Get<uint32_t>(bytes, pos);
+    uint32_t slots         = Get<uint32_t>(bytes, pos);
+    double scalingFactor   = Get<double>(bytes, pos);
+    uint32_t keyTagSize    = Get<uint32_t>(bytes, pos);
+    if (pos + keyTagSize > bytes.size()) {
+        OPENFHE_THROW(openfhe_error, "Truncated compact ciphertext");
+    }
+    std::string keyTag(bytes.substr(pos, keyTagSize));
+    pos += keyTagSize;
+    uint32_t numElements = Get<uint32_t>(bytes, pos);
+    uint32_t numTowers   = Get<uint32_t>(bytes, pos);
+    uint32_t ringDim     = Get<uint32_t>(bytes, pos);
+
+    // the remaining towers are the lowest ones of the context's modulus chain
+    auto fullParams         = cc->GetElementParams();
+    const auto& towerParams = fullParams->GetParams();
+    if (numTowers == 0 || numTowers > towerParams.size()) {
+        OPENFHE_THROW(openfhe_error, "Compact ciphertext does not match the crypto context");
+    }
+    std::vector<NativeInteger> moduli(numTowers);
+    std::vector<NativeInteger> rootsOfUnity(numTowers);
+    std::vector<uint32_t> widths(numTowers);
+    for (uint32_t i = 0; i < numTowers; ++i) {
+        moduli[i]       = towerParams[i]->GetModulus();
+        rootsOfUnity[i] = towerParams[i]->GetRootOfUnity();
+        widths[i]       = Get<uint8_t>(bytes, pos);
+        if (widths[i] != BitWidth(moduli[i].ConvertToInt())) {
+            OPENFHE_THROW(openfhe_error, "Compact ciphertext does not match the crypto context");
+        }
+    }
+    auto params = std::make_shared<DCRTPoly::Params>(fullParams->GetCyclotomicOrder(), moduli, rootsOfUnity);
+
+    BitReader reader(bytes, pos);
+    std::vector<DCRTPoly> elements;
+    elements.reserve(numElements);
+    for (uint32_t e = 0; e < numElements; ++e) {
+        DCRTPoly poly(params, Format::EVALUATION, true);
+        for (uint32_t i = 0; i < numTowers; ++i) {
+            NativePoly element = poly.GetElementAtIndex(i);
+            if (element.GetLength() != ringDim) {
+                OPENFHE_THROW(openfhe_error, "Compact ciphertext does not match the crypto context");
+            }
+            for (uint32_t j = 0; j < ringDim; ++j) {
+                element[j] = NativeInteger(reader.Read(widths[i]));
+            }
+            poly.SetElementAtIndex(i, std::move(element));
+        }
+        elements.push_back(std::move(poly));
+    }
+
+    auto ct = std::make_shared<CiphertextImpl<DCRTPoly>>(cc);
+    ct->SetElements(std::move(elements));
+    ct->SetLevel(level);
+    ct->SetNoiseScaleDeg(noiseScaleDeg);
+    ct->SetSlots(slots);
+    ct->SetScalingFactor(scalingFactor);
+    ct->SetEncodingType(CKKS_PACKED_ENCODING);
+    ct->SetKeyTag(keyTag);
+    return ct;
+}
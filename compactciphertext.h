@@ -0,0 +1,68 @@
+#ifndef OPENFHE_COMPACTCIPHERTEXT_H
+#define OPENFHE_COMPACTCIPHERTEXT_H
+
+#include "openfhe.h"
+
+#include <string>
+#include <string_view>
+
+using namespace lbcrypto;
+
+/**
+ * Compact wire format for party ciphertexts. Aggregation only adds, so a
+ * ciphertext can be mod-reduced to the lowest level the downstream Chebyshev
+ * evaluation still needs before upload; the remaining RNS towers are stored
+ * bit-packed at the width of their modulus instead of one 64-bit word per
+ * coefficient.
+ *
+ * Replacing the second ciphertext component by a PRNG seed is only possible
+ * for secret-key encryptions. Parties encrypt under the joint public key, where
+ * that component is v * pk_1 + e_1 for a secret v and is not reproducible from
+ * a seed, so the format does not offer it.
+ *
+ * Layout (little endian): "SSCC", version, level, noise scale degree, slots,
+ * scaling factor (double), key tag, #elements, #towers, ring dimension, bit
+ * width per tower, then the packed coefficients element by element, tower by
+ * tower, in EVALUATION format.
+ */
+class CompactCodec {
+public:
+    static constexpr uint32_t VERSION = 1;
+
+    explicit CompactCodec(const CryptoContext<DCRTPoly>& cc);
+
+    /**
+     * Levels a fresh ciphertext can drop in a context of depth multDepth and
+     * still support an evaluation that consumes neededDepth levels.
+     */
+    static uint32_t LevelsToDrop(uint32_t multDepth, uint32_t neededDepth);
+
+    /**
+     * Serializes ct at its current level; drop levels with LevelReduce first.
+     */
+    std::string Export(const Ciphertext<DCRTPoly>& ct) const;
+
+    Ciphertext<DCRTPoly> Import(std::string_view bytes) const;
+
+    /**
+     * True if bytes start with the compact format's magic.
+     */
+    static bool IsCompact(std::string_view bytes);
+
+private:
+    CryptoContext<DCRTPoly> cc;
+};
+
+/**
+ * Serializes ct with CompactCodec::Export if compact is set, otherwise with
+ * Serial::Serialize(..., SerType::BINARY).
+ */
+std::string EncodeCiphertext(const CryptoContext<DCRTPoly>& cc, const Ciphertext<DCRTPoly>& ct, bool compact);
+
+/**
+ * Deserializes a ciphertext in either wire format: CompactCodec::Export output
+ * or Serial::Serialize(..., SerType::BINARY) output. bytes is not copied.
+ */
+Ciphertext<DCRTPoly> DecodeCiphertext(const CryptoContext<DCRTPoly>& cc, std::string_view bytes);
+
+#endif  //OPENFHE_COMPACTCIPHERTEXT_H
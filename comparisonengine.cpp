@@ -0,0 +1,189 @@
+#include "comparisonengine.h"
+#include "tracer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <tuple>
+
+namespace {
+
+// coefficients of z, z^3 of the sign polynomial g
+const std::vector<double> SIGN_COEFFICIENTS = {2126.0 / 1024, -1359.0 / 1024};
+
+// largest Chebyshev degrees of depths 4, 5, 6, ...
+const uint32_t CHEBYSHEV_DEGREE_BOUNDS[] = {5, 13, 27, 59, 119, 247, 495, 1007, 2031};
+
+// ReluError samples per coefficient, enough to resolve every ripple of the series
+const uint32_t ERROR_SAMPLES_PER_DEGREE = 16;
+
+// The Chebyshev series c[0] / 2 + sum_k c[k] T_k(y) at y = x / width, as
+// EvalChebyshevSeries evaluates it on [-width, width] (Clenshaw's recurrence).
+double ChebyshevValue(const std::vector<double>& c, double width, double x) {
+    const double y = x / width;
+    double b1      = 0;
+    double b2      = 0;
+    for (size_t k = c.size() - 1; k > 0; --k) {
+        const double b0 = c[k] + 2 * y * b1 - b2;
+        b2              = b1;
+        b1              = b0;
+    }
+    return c[0] / 2 + y * b1 - b2;
+}
+
+// Odd polynomial sum_k c[k] z^(2k+1) in ceil(log2(2 c.size())) levels: every
+// term starts from the constant product c[k] z and is multiplied by the
+// squarings z^2, z^4, ... selected by the bits of k.
+Ciphertext<DCRTPoly> EvalOddPolynomial(const CryptoContext<DCRTPoly>& cc, const Ciphertext<DCRTPoly>& z,
+                                       const std::vector<double>& c) {
+    // squarings[b] = z^(2^(b+1))
+    std::vector<Ciphertext<DCRTPoly>> squarings;
+    Ciphertext<DCRTPoly> result;
+    for (size_t k = 0; k < c.size(); ++k) {
+        auto term = cc->EvalMult(z, c[k]);
+        for (size_t bit = 0; (k >> bit) != 0; ++bit) {
+            if (squarings.size() <= bit) {
+                squarings.push_back(cc->EvalSquare(squarings.empty() ? z : squarings.back()));
+                TraceCount("key_switches");
+            }
+            if ((k >> bit) & 1) {
+                term = cc->EvalMult(term, squarings[bit]);
+                TraceCount("key_switches");
+            }
+        }
+        result = (result == nullptr) ? term : cc->EvalAdd(result, term);
+    }
+    return result;
+}
+
+}  // namespace
+
+ComparisonEngine::ComparisonEngine(const CryptoContext<DCRTPoly>& cc, double lowerBound, double upperBound,
+                                   uint32_t degree, uint32_t multDepth, uint32_t signIterations)
+    : cc(cc), lowerBound(lowerBound), upperBound(upperBound), signIterations(signIterations) {
+    if (!(lowerBound < upperBound)) {
+        OPENFHE_THROW(config_error, "The comparison needs lowerBound < upperBound");
+    }
+    if (degree > 0 && ChebyshevDepth(degree) > multDepth) {
+        OPENFHE_THROW(config_error, "A Chebyshev series of degree " + std::to_string(degree) + " needs depth " +
+                                        std::to_string(ChebyshevDepth(degree)) + ", the context has " +
+                                        std::to_string(multDepth));
+    }
+    if (signIterations > 0 && SignDepth(signIterations) > multDepth) {
+        OPENFHE_THROW(config_error, std::to_string(signIterations) + " sign iterations need depth " +
+                                        std::to_string(SignDepth(signIterations)) + ", the context has " +
+                                        std::to_string(multDepth));
+    }
+    if (degree > 0) {
+        const double width = upperBound - lowerBound;
+        reluError          = ReluError(width, degree);
+        if (reluError > MAX_RELU_ERROR) {
+            OPENFHE_THROW(config_error, "The degree " + std::to_string(degree) + " ReLU approximation on [-" +
+                                            std::to_string(width) + ", " + std::to_string(width) + "] is off by " +
+                                            std::to_string(reluError) + " at the kink, more than " +
+                                            std::to_string(MAX_RELU_ERROR) + "; it needs degree " +
+                                            std::to_string(ReluDegree(width)));
+        }
+        coefficients = ReluCoefficients(width, degree, multDepth);
+    }
+}
+
+Ciphertext<DCRTPoly> ComparisonEngine::EvalMax(const Ciphertext<DCRTPoly>& ct, double threshold) const {
+    if (threshold < lowerBound || threshold > upperBound) {
+        OPENFHE_THROW(config_error, "Threshold " + std::to_string(threshold) + " is outside [" +
+                                        std::to_string(lowerBound) + ", " + std::to_string(upperBound) + "]");
+    }
+    if (coefficients == nullptr) {
+        OPENFHE_THROW(config_error, "The comparison engine was set up without a ReLU approximation");
+    }
+    const double width = upperBound - lowerBound;
+    auto difference    = cc->EvalSub(ct, threshold);
+    auto relu          = cc->EvalChebyshevSeries(difference, *coefficients, -width, width);
+    TraceCount("chebyshev_series");
+    TraceCount("rescales", relu->GetLevel() - ct->GetLevel());
+    return cc->EvalAdd(relu, threshold);
+}
+
+Ciphertext<DCRTPoly> ComparisonEngine::EvalGreater(const Ciphertext<DCRTPoly>& ct, double threshold) const {
+    if (threshold < lowerBound || threshold > upperBound) {
+        OPENFHE_THROW(config_error, "Threshold " + std::to_string(threshold) + " is outside [" +
+                                        std::to_string(lowerBound) + ", " + std::to_string(upperBound) + "]");
+    }
+    if (signIterations == 0) {
+        OPENFHE_THROW(config_error, "The comparison engine was set up without sign iterations");
+    }
+    // |x - midpoint| <= width + 0.5, so z stays inside [-1, 1] where g is monotone
+    const double midpoint = std::floor(threshold) + 0.5;
+    const double width    = upperBound - lowerBound + 1;
+    auto z                = cc->EvalMult(cc->EvalSub(ct, midpoint), 1.0 / width);
+    for (uint32_t i = 0; i < signIterations; ++i) {
+        z = EvalOddPolynomial(cc, z, SIGN_COEFFICIENTS);
+    }
+    TraceCount("rescales", z->GetLevel() - ct->GetLevel());
+    return z;
+}
+
+uint32_t ComparisonEngine::ChebyshevDepth(uint32_t degree) {
+    uint32_t depth = 4;
+    for (uint32_t bound : CHEBYSHEV_DEGREE_BOUNDS) {
+        if (degree <= bound) {
+            return depth;
+        }
+        ++depth;
+    }
+    OPENFHE_THROW(config_error, "Chebyshev degree " + std::to_string(degree) + " is not supported");
+}
+
+uint32_t ComparisonEngine::SignDepth(uint32_t signIterations) {
+    // one level for the normalization, two per degree-3 round
+    return 1 + 2 * signIterations;
+}
+
+std::shared_ptr<const std::vector<double>> ComparisonEngine::ReluCoefficients(double width, uint32_t degree,
+                                                                              uint32_t multDepth) {
+    using Key = std::tuple<double, uint32_t, uint32_t>;
+    static std::mutex mtx;
+    static std::map<Key, std::shared_ptr<const std::vector<double>>> cache;
+
+    std::lock_guard<std::mutex> lock(mtx);
+    auto& entry = cache[Key(width, degree, multDepth)];
+    if (entry == nullptr) {
+        entry = std::make_shared<const std::vector<double>>(
+            EvalChebyshevCoefficients([](double x) -> double { return std::max(0.0, x); }, -width, width, degree));
+    }
+    return entry;
+}
+
+double ComparisonEngine::ReluError(double width, uint32_t degree) {
+    using Key = std::tuple<double, uint32_t>;
+    static std::mutex mtx;
+    static std::map<Key, double> cache;
+
+    std::lock_guard<std::mutex> lock(mtx);
+    auto found = cache.find(Key(width, degree));
+    if (found != cache.end()) {
+        return found->second;
+    }
+    const auto relu = [](double x) -> double { return std::max(0.0, x); };
+    const auto c    = EvalChebyshevCoefficients(relu, -width, width, degree);
+    // the grid holds x = 0, where the error peaks
+    const uint32_t halfSamples = ERROR_SAMPLES_PER_DEGREE * (degree + 1);
+    double error               = 0;
+    for (int64_t i = -int64_t(halfSamples); i <= int64_t(halfSamples); ++i) {
+        const double x = width * i / halfSamples;
+        error          = std::max(error, std::abs(ChebyshevValue(c, width, x) - relu(x)));
+    }
+    cache.emplace(Key(width, degree), error);
+    return error;
+}
+
+uint32_t ComparisonEngine::ReluDegree(double width) {
+    for (uint32_t degree : CHEBYSHEV_DEGREE_BOUNDS) {
+        if (ReluError(width, degree) <= MAX_RELU_ERROR) {
+            return degree;
+        }
+    }
+    OPENFHE_THROW(config_error, "No supported Chebyshev degree approximates ReLU on [-" + std::to_string(width) +
+                                    ", " + std::to_string(width) + "] within " + std::to_string(MAX_RELU_ERROR));
+}
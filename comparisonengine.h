@@ -0,0 +1,121 @@
+#ifndef OPENFHE_COMPARISONENGINE_H
+#define OPENFHE_COMPARISONENGINE_H
+
+#include "openfhe.h"
+
+#include <memory>
+#include <vector>
+
+using namespace lbcrypto;
+
+/**
+ * Homomorphic max(threshold, x) without per-threshold Chebyshev coefficients.
+ * Instead of approximating max(threshold, x) for every threshold, one ReLU
+ * approximation over the difference interval [lower - upper, upper - lower] is
+ * computed once and cached process-wide, keyed by (bounds, degree, depth). A
+ * query then only subtracts its threshold as a plaintext constant, evaluates
+ * the cached series and adds the threshold back:
+ *
+ *     max(threshold, x) = threshold + ReLU(x - threshold)
+ *
+ * Constant additions consume no level, so the depth is that of the series alone.
+ * The series is least accurate at the kink: with the difference interval of
+ * width 40, degree 27 puts x == threshold about 0.7 above the threshold. The
+ * engine therefore measures the error of every approximation it computes and
+ * rejects one that is off by more than MAX_RELU_ERROR; ReluDegree picks the
+ * smallest degree that is not.
+ *
+ * When only the decision is needed, EvalGreater evaluates a composite sign
+ * approximation instead: the difference is normalized to [-1, 1] and passed
+ * through signIterations rounds of the odd degree-3 polynomial
+ *
+ *     g(z) = (2126 z - 1359 z^3) / 1024
+ *
+ * (Cheon et al., "Efficient Homomorphic Comparison Methods with Optimal
+ * Complexity"), which pushes every z away from 0 towards +-1. Each round costs
+ * two levels and the normalization one, so SignDepth(1) = 3 against the seven
+ * levels of the degree-59 ReLU series the default bounds need.
+ */
+class ComparisonEngine {
+public:
+    /**
+     * Largest error of the ReLU approximation EvalMax accepts, against the unit
+     * spacing of the integer aggregates: x == threshold and x == threshold + 1
+     * stay on either side of threshold + 0.5 with a margin for the CKKS noise.
+     */
+    static constexpr double MAX_RELU_ERROR = 0.4;
+
+    /**
+     * @param lowerBound, upperBound - range of the inputs x and of the thresholds
+     * @param degree - Chebyshev degree of the ReLU approximation, whose error on
+     *   the bounds must not exceed MAX_RELU_ERROR; 0 disables EvalMax
+     * @param multDepth - multiplicative depth of cc; must cover the enabled kernels
+     * @param signIterations - rounds of the sign polynomial; 0 disables EvalGreater
+     */
+    ComparisonEngine(const CryptoContext<DCRTPoly>& cc, double lowerBound, double upperBound, uint32_t degree,
+                     uint32_t multDepth, uint32_t signIterations = 0);
+
+    /**
+     * max(threshold, x) for every slot x of ct, up to GetReluError(); threshold
+     * must lie within the bounds.
+     */
+    Ciphertext<DCRTPoly> EvalMax(const Ciphertext<DCRTPoly>& ct, double threshold) const;
+
+    /**
+     * Positive for every integer slot x > threshold and negative for x <= threshold,
+     * approaching +-1 with every sign iteration. The comparison is against the
+     * midpoint floor(threshold) + 0.5, so no slot is closer than half a unit to
+     * the decision boundary; the sign of the decrypted value is the decision.
+     */
+    Ciphertext<DCRTPoly> EvalGreater(const Ciphertext<DCRTPoly>& ct, double threshold) const;
+
+    /**
+     * Multiplicative depth EvalChebyshevSeries consumes for a polynomial of the
+     * given degree (Paterson-Stockmeyer, as in OpenFHE's function evaluation docs).
+     */
+    static uint32_t ChebyshevDepth(uint32_t degree);
+
+    /**
+     * Multiplicative depth of EvalGreater with the given number of rounds.
+     */
+    static uint32_t SignDepth(uint32_t signIterations);
+
+    /**
+     * Coefficients of the ReLU approximation on [-width, width], computed on the
+     * first request for (width, degree, multDepth) and shared afterwards. Thread safe.
+     */
+    static std::shared_ptr<const std::vector<double>> ReluCoefficients(double width, uint32_t degree,
+                                                                       uint32_t multDepth);
+
+    /**
+     * Largest deviation of the degree-degree ReLU approximation from ReLU on
+     * [-width, width], sampled densely in plaintext; it peaks at the kink.
+     * Cached like the coefficients.
+     */
+    static double ReluError(double width, uint32_t degree);
+
+    /**
+     * Smallest degree whose ReLU approximation on [-width, width] is within
+     * MAX_RELU_ERROR, among the largest degrees of every Chebyshev depth.
+     * The error shrinks about linearly with the degree, so wider bounds need
+     * proportionally higher degrees.
+     */
+    static uint32_t ReluDegree(double width);
+
+    /**
+     * Error of the ReLU approximation behind EvalMax (see ReluError); 0 without one.
+     */
+    double GetReluError() const {
+        return reluError;
+    }
+
+private:
+    CryptoContext<DCRTPoly> cc;
+    double lowerBound;
+    double upperBound;
+    uint32_t signIterations;
+    std::shared_ptr<const std::vector<double>> coefficients;
+    double reluError = 0;
+};
+
+#endif  //OPENFHE_COMPARISONENGINE_H
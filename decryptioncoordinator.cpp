@@ -0,0 +1,217 @@
+#include "decryptioncoordinator.h"
+#include "tracer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <iterator>
+#include <set>
+
+namespace {
+
+Ciphertext<DCRTPoly> PartialDecryption(const CryptoContext<DCRTPoly>& cc, usint party,
+                                       const PrivateKey<DCRTPoly>& secretKey, const Ciphertext<DCRTPoly>& ct) {
+    TraceScope scope("partial_decrypt", party + 1);
+    return (party == 0) ? cc->MultipartyDecryptLead({ct}, secretKey)[0] : cc->MultipartyDecryptMain({ct}, secretKey)[0];
+}
+
+// state of one Decrypt call, shared with the responder and recovery tasks
+struct Round {
+    Round(const CryptoContext<DCRTPoly>& cc, usint numParties)
+        : accumulator(cc, numParties), delivered(numParties, false), failed(numParties, false) {}
+
+    // the first partial of a party wins; later ones are dropped
+    void Deliver(usint party, const Ciphertext<DCRTPoly>& partial, bool fromRecovery) {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            if (delivered[party]) {
+                return;
+            }
+            delivered[party] = true;
+            ++numDelivered;
+            if (fromRecovery) {
+                ++numRecovered;
+            }
+            accumulator.Add(partial);
+        }
+        cv.notify_all();
+    }
+
+    void Fail(usint party) {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            failed[party] = true;
+        }
+        cv.notify_all();
+    }
+
+    void Abort(std::exception_ptr e) {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            if (!error) {
+                error = e;
+            }
+        }
+        cv.notify_all();
+    }
+
+    std::mutex mtx;
+    std::condition_variable cv;
+    FusionAccumulator accumulator;
+    std::vector<bool> delivered;
+    std::vector<bool> failed;
+    size_t numDelivered = 0;
+    size_t numRecovered = 0;
+    std::exception_ptr error;
+};
+
+}  // namespace
+
+double LatencyStats::Percentile(double p) const {
+    if (latenciesMs.empty()) {
+        return 0;
+    }
+    std::vector<double> sorted = latenciesMs;
+    std::sort(sorted.begin(), sorted.end());
+    size_t rank = static_cast<size_t>(std::ceil(p / 100 * sorted.size()));
+    return sorted[std::min(sorted.size(), std::max<size_t>(rank, 1)) - 1];
+}
+
+DecryptionCoordinator::DecryptionCoordinator(const SchemeSwitchPipeline& pipeline, std::chrono::milliseconds deadline)
+    : pipeline(pipeline), deadline(deadline) {}
+
+DecryptionCoordinator::~DecryptionCoordinator() {
+    std::lock_guard<std::mutex> lock(mtx);
+    for (auto& task : pending) {
+        task.wait();
+    }
+}
+
+DecryptionCoordinator::PartialSource DecryptionCoordinator::LocalSource(const SchemeSwitchPipeline& pipeline,
+                                                                        const std::set<usint>& dropped) {
+    return [&pipeline, dropped](usint party, const Ciphertext<DCRTPoly>& ct) {
+        if (dropped.count(party) != 0) {
+            OPENFHE_THROW(openfhe_error, "Party " + std::to_string(party + 1) + " dropped out");
+        }
+        return PartialDecryption(pipeline.GetCryptoContext(), party, pipeline.GetParties().at(party).GetSecretKey(),
+                                 ct);
+    };
+}
+
+LatencyStats DecryptionCoordinator::GetStats() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return stats;
+}
+
+void DecryptionCoordinator::Submit(std::function<void()> fn) {
+    auto task = pipeline.GetThreadPool().Submit(std::move(fn));
+    std::lock_guard<std::mutex> lock(mtx);
+    pending.push_back(std::move(task));
+}
+
+void DecryptionCoordinator::ReapTasks() {
+    std::lock_guard<std::mutex> lock(mtx);
+    pending.erase(std::remove_if(pending.begin(), pending.end(),
+                                 [](const std::future<void>& task) {
+                                     return task.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+                                 }),
+                  pending.end());
+}
+
+Plaintext DecryptionCoordinator::Decrypt(const Ciphertext<DCRTPoly>& ct, const PartialSource& source) {
+    if (pipeline.GetThreadPool().IsWorkerThread()) {
+        OPENFHE_THROW(openfhe_error, "DecryptionCoordinator::Decrypt waits for the thread pool it is called from");
+    }
+    ReapTasks();
+
+    const auto start                  = std::chrono::steady_clock::now();
+    const auto deadlineTime           = start + deadline;
+    const usint numParties            = pipeline.GetParams().numParties;
+    const CryptoContext<DCRTPoly>& cc = pipeline.GetCryptoContext();
+
+    auto round = std::make_shared<Round>(cc, numParties);
+    for (usint i = 0; i < numParties; ++i) {
+        Submit([round, source, ct, i] {
+            try {
+                round->Deliver(i, source(i, ct), false);
+            }
+            catch (...) {
+                round->Fail(i);
+            }
+        });
+    }
+
+    std::set<usint> speculated;
+    std::unique_lock<std::mutex> lock(round->mtx);
+    while (round->numDelivered < numParties) {
+        if (round->error) {
+            std::rethrow_exception(round->error);
+        }
+
+        const bool deadlinePassed = std::chrono::steady_clock::now() >= deadlineTime;
+        std::set<usint> missing, toRecover;
+        bool newFailure = false;
+        for (usint i = 0; i < numParties; ++i) {
+            if (round->delivered[i]) {
+                continue;
+            }
+            missing.insert(i);
+            if (speculated.count(i) == 0) {
+                toRecover.insert(i);
+                newFailure = newFailure || round->failed[i];
+            }
+        }
+
+        if ((deadlinePassed || newFailure) && !toRecover.empty()) {
+            if (missing.size() <= pipeline.GetMaxRecoverable()) {
+                speculated.insert(toRecover.begin(), toRecover.end());
+                // the shares of parties still being recovered cannot be collected either
+                std::set<usint> unavailable;
+                std::set_difference(missing.begin(), missing.end(), toRecover.begin(), toRecover.end(),
+                                    std::inserter(unavailable, unavailable.end()));
+                Submit([this, round, ct, toRecover, unavailable] {
+                    try {
+                        auto keys = pipeline.RecoverKeys(toRecover, unavailable);
+                        std::vector<usint> parties(toRecover.begin(), toRecover.end());
+                        pipeline.GetThreadPool().ParallelFor(0, parties.size(), [&](size_t k) {
+                            round->Deliver(parties[k],
+                                           PartialDecryption(pipeline.GetCryptoContext(), parties[k],
+                                                             keys.at(parties[k]), ct),
+                                           true);
+                        });
+                    }
+                    catch (...) {
+                        round->Abort(std::current_exception());
+                    }
+                });
+            }
+            else {
+                for (usint i : toRecover) {
+                    if (round->failed[i]) {
+                        OPENFHE_THROW(openfhe_error, "Party " + std::to_string(i + 1) +
+                                                         " failed and its key cannot be recovered");
+                    }
+                }
+            }
+        }
+
+        if (deadlinePassed) {
+            round->cv.wait(lock);
+        }
+        else {
+            round->cv.wait_until(lock, deadlineTime);
+        }
+    }
+
+    Plaintext result = round->accumulator.Finalize();
+    const double latencyMs =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    const size_t numRecovered = round->numRecovered;
+    lock.unlock();
+
+    std::lock_guard<std::mutex> statsLock(mtx);
+    stats.latenciesMs.push_back(latencyMs);
+    stats.speculativeRecoveries += speculated.size();
+    stats.recoveredPartials += numRecovered;
+    return result;
+}
@@ -0,0 +1,98 @@
+#ifndef OPENFHE_DECRYPTIONCOORDINATOR_H
+#define OPENFHE_DECRYPTIONCOORDINATOR_H
+
+#include "openfhe.h"
+
+#include "pipeline.h"
+
+#include <chrono>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+
+using namespace lbcrypto;
+
+struct LatencyStats {
+    // end-to-end latency of every decryption
+    std::vector<double> latenciesMs;
+    // parties whose key recovery was started speculatively
+    size_t speculativeRecoveries = 0;
+    // partials that came from a recovered key before the party delivered its own
+    size_t recoveredPartials = 0;
+
+    /**
+     * Nearest-rank percentile of latenciesMs; p in [0, 100].
+     */
+    double Percentile(double p) const;
+};
+
+/**
+ * Threshold decryption that does not wait for stragglers forever. All parties
+ * are asked for their partial decryption at once. When the deadline passes, or
+ * as soon as a party reports failure, the secret keys of the parties still
+ * missing are recovered from their shares in the background (see
+ * SchemeSwitchPipeline::RecoverKeys) and used to compute their partials.
+ * Whichever partial of a party is ready first is fused (see FusionAccumulator).
+ *
+ * Speculation needs params.faultTolerant and at most GetMaxRecoverable()
+ * missing parties; otherwise the coordinator keeps waiting for the parties.
+ *
+ * The requests and recoveries run on the pipeline's thread pool. A source that
+ * blocks while its party is slow holds a worker meanwhile, so the pool needs
+ * more workers than parties that may straggle at once, or the recoveries queue
+ * behind them.
+ */
+class DecryptionCoordinator {
+public:
+    /**
+     * Returns party's partial decryption of ct, MultipartyDecryptLead output for
+     * party 0 and MultipartyDecryptMain output otherwise. Called on a pool
+     * worker per party; may block as long as the party takes and throws if the
+     * party dropped out.
+     */
+    using PartialSource = std::function<Ciphertext<DCRTPoly>(usint party, const Ciphertext<DCRTPoly>& ct)>;
+
+    DecryptionCoordinator(const SchemeSwitchPipeline& pipeline, std::chrono::milliseconds deadline);
+
+    // waits for the straggling parties and recoveries of earlier decryptions
+    ~DecryptionCoordinator();
+
+    DecryptionCoordinator(const DecryptionCoordinator&)            = delete;
+    DecryptionCoordinator& operator=(const DecryptionCoordinator&) = delete;
+
+    /**
+     * Decrypts ct with the partials of all parties, recovering stragglers' keys
+     * after the deadline. Throws openfhe_error if a party failed and its key
+     * cannot be recovered. Must not be called from a worker of the pipeline's
+     * thread pool, whose workers it waits for.
+     */
+    Plaintext Decrypt(const Ciphertext<DCRTPoly>& ct, const PartialSource& source);
+
+    /**
+     * Source computing every partial in-process with the party's own key; the
+     * 0-based parties in dropped fail instead, as if they had dropped out.
+     */
+    static PartialSource LocalSource(const SchemeSwitchPipeline& pipeline, const std::set<usint>& dropped = {});
+
+    LatencyStats GetStats() const;
+
+private:
+    // queues fn on the pipeline's thread pool
+    void Submit(std::function<void()> fn);
+
+    // drops the futures of the tasks that finished
+    void ReapTasks();
+
+    const SchemeSwitchPipeline& pipeline;
+    std::chrono::milliseconds deadline;
+
+    mutable std::mutex mtx;
+    LatencyStats stats;
+    // responder and recovery tasks; stragglers may outlive their Decrypt call
+    std::vector<std::future<void>> pending;
+};
+
+#endif  //OPENFHE_DECRYPTIONCOORDINATOR_H
@@ -0,0 +1,138 @@
+#include "decryptor.h"
+#include "memoryreport.h"
+#include "tracer.h"
+
+#include <algorithm>
+#include <memory>
+
+FusionAccumulator::FusionAccumulator(const CryptoContext<DCRTPoly>& cc, size_t expected) : cc(cc), expected(expected) {
+    if (expected == 0) {
+        OPENFHE_THROW(openfhe_error, "Fusion needs at least one partial decryption");
+    }
+}
+
+bool FusionAccumulator::Add(const Ciphertext<DCRTPoly>& partial) {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (received == expected) {
+        OPENFHE_THROW(openfhe_error, "More partial decryptions than expected");
+    }
+    if (sum == nullptr) {
+        // the partial belongs to the caller
+        sum = partial->Clone();
+    }
+    else {
+        sum->GetElements()[0] += partial->GetElements()[0];
+    }
+    return ++received == expected;
+}
+
+bool FusionAccumulator::IsComplete() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return received == expected;
+}
+
+Plaintext FusionAccumulator::Finalize() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (received != expected) {
+        OPENFHE_THROW(openfhe_error, "Only " + std::to_string(received) + " of " + std::to_string(expected) +
+                                         " partial decryptions received");
+    }
+    // fusing the single, already summed partial only decodes it
+    TraceScope scope("fusion");
+    Plaintext result;
+    cc->MultipartyDecryptFusion({sum}, &result);
+    return result;
+}
+
+Decryptor::Decryptor(const CryptoContext<DCRTPoly>& cc, ThreadPool& pool) : cc(cc), pool(pool) {}
+
+Plaintext Decryptor::Decrypt(const Ciphertext<DCRTPoly>& ciphertext,
+                             const std::vector<PrivateKey<DCRTPoly>>& secretKeys) const {
+    return DecryptBatch({ciphertext}, secretKeys)[0];
+}
+
+std::vector<Plaintext> Decryptor::DecryptBatch(const std::vector<Ciphertext<DCRTPoly>>& ciphertexts,
+                                               const std::vector<PrivateKey<DCRTPoly>>& secretKeys,
+                                               const std::vector<uint32_t>& partyIds) const {
+    if (secretKeys.empty()) {
+        OPENFHE_THROW(openfhe_error, "Threshold decryption needs at least one secret key");
+    }
+    if (ciphertexts.empty()) {
+        return {};
+    }
+
+    // Split the batch just finely enough that every worker gets a (key, chunk)
+    // pair; larger chunks amortize the per-call overhead.
+    const size_t numKeys   = secretKeys.size();
+    const size_t numCts    = ciphertexts.size();
+    const size_t numChunks = std::min(numCts, std::max<size_t>(1, (pool.Size() + numKeys - 1) / numKeys));
+    const size_t chunkSize = (numCts + numChunks - 1) / numChunks;
+
+    std::vector<std::unique_ptr<FusionAccumulator>> accumulators(numCts);
+    for (auto& accumulator : accumulators) {
+        accumulator = std::make_unique<FusionAccumulator>(cc, numKeys);
+    }
+    pool.ParallelFor(0, numKeys * numChunks, [&](size_t job) {
+        const size_t k     = job / numChunks;
+        const size_t begin = (job % numChunks) * chunkSize;
+        const size_t end   = std::min(numCts, begin + chunkSize);
+        if (begin >= end) {
+            return;
+        }
+        TraceScope scope("partial_decrypt", (k < partyIds.size()) ? partyIds[k] : uint32_t(k + 1));
+        std::vector<Ciphertext<DCRTPoly>> chunk(ciphertexts.begin() + begin, ciphertexts.begin() + end);
+        auto partial = (k == 0) ? cc->MultipartyDecryptLead(chunk, secretKeys[k]) :
+                                  cc->MultipartyDecryptMain(chunk, secretKeys[k]);
+        if (job == 0) {
+            // one partial per key and ciphertext is produced; the accumulators fold them as they arrive
+            MemoryReport::Global().RecordCiphertext("partial decryption", partial[0], numKeys * numCts);
+        }
+        for (size_t c = begin; c < end; ++c) {
+            accumulators[c]->Add(partial[c - begin]);
+        }
+    });
+
+    std::vector<Plaintext> results(numCts);
+    pool.ParallelFor(0, numCts, [&](size_t c) { results[c] = accumulators[c]->Finalize(); });
+    return results;
+}
+
+PrivateKey<DCRTPoly> Decryptor::RecoverKey(const std::unordered_map<uint32_t, DCRTPoly>& shares, usint numParties,
+                                           usint threshold, const std::string& shareType) const {
+    TraceScope scope("recover_shared_key");
+    // RecoverSharedKey takes the share map by non-const reference
+    auto sharesCopy                   = shares;
+    PrivateKey<DCRTPoly> recoveredKey = std::make_shared<PrivateKeyImpl<DCRTPoly>>(cc);
+    cc->RecoverSharedKey(recoveredKey, sharesCopy, numParties, threshold, shareType);
+    return recoveredKey;
+}
+
+PrivateKey<DCRTPoly> Decryptor::LagrangeWeightedKey(uint32_t index, const DCRTPoly& share,
+                                                    const std::vector<uint32_t>& participants) const {
+    if (std::find(participants.begin(), participants.end(), index) == participants.end()) {
+        OPENFHE_THROW(openfhe_error, "Share " + std::to_string(index) + " is not among the participants");
+    }
+
+    // lambda = prod_{m != index} m / (m - index) mod q, for every tower modulus q
+    const auto& towers = share.GetParams()->GetParams();
+    std::vector<NativeInteger> lambdas(towers.size());
+    for (size_t k = 0; k < towers.size(); ++k) {
+        const NativeInteger q = towers[k]->GetModulus();
+        NativeInteger numerator(1), denominator(1);
+        for (uint32_t m : participants) {
+            if (m == index) {
+                continue;
+            }
+            numerator   = numerator.ModMul(NativeInteger(m).Mod(q), q);
+            denominator = denominator.ModMul(NativeInteger(m).Mod(q).ModSub(NativeInteger(index).Mod(q), q), q);
+        }
+        lambdas[k] = numerator.ModMul(denominator.ModInverse(q), q);
+    }
+
+    // the shares are in COEFFICIENT format; decryption needs EVALUATION, as in RecoverSharedKey
+    DCRTPoly weighted = share.Times(lambdas);
+    weighted.SetFormat(Format::EVALUATION);
+    PrivateKey<DCRTPoly> weightedKey = std::make_shared<PrivateKeyImpl<DCRTPoly>>(cc);
+    weightedKey->SetPrivateElement(weighted);
+    return weightedKey;
+}
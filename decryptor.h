@@ -0,0 +1,100 @@
+#ifndef OPENFHE_DECRYPTOR_H
+#define OPENFHE_DECRYPTOR_H
+
+#include "openfhe.h"
+#include "threadpool.h"
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace lbcrypto;
+
+/**
+ * Incremental MultipartyDecryptFusion. Fusion adds the partial decryptions and
+ * decodes the sum, so each partial can be added into a running sum as soon as
+ * its party delivers it; only the decoding is left once the last one arrived.
+ * Add is thread safe.
+ */
+class FusionAccumulator {
+public:
+    /**
+     * @param expected - number of partial decryptions (participating parties)
+     */
+    FusionAccumulator(const CryptoContext<DCRTPoly>& cc, size_t expected);
+
+    /**
+     * Folds in one partial decryption (MultipartyDecryptLead or Main output).
+     * @return true if this was the last expected partial
+     */
+    bool Add(const Ciphertext<DCRTPoly>& partial);
+
+    bool IsComplete() const;
+
+    /**
+     * Decodes the sum of the partials; throws openfhe_error if some are missing.
+     */
+    Plaintext Finalize() const;
+
+private:
+    CryptoContext<DCRTPoly> cc;
+    size_t expected;
+
+    mutable std::mutex mtx;
+    size_t received = 0;
+    Ciphertext<DCRTPoly> sum;
+};
+
+/**
+ * Threshold decryption: every participating key produces a partial decryption
+ * (concurrently on the thread pool) and the partials are fused into the plaintext.
+ */
+class Decryptor {
+public:
+    Decryptor(const CryptoContext<DCRTPoly>& cc, ThreadPool& pool);
+
+    /**
+     * @param ciphertext - ciphertext encrypted under the joint public key
+     * @param secretKeys - one secret key per party; the first one runs MultipartyDecryptLead
+     */
+    Plaintext Decrypt(const Ciphertext<DCRTPoly>& ciphertext, const std::vector<PrivateKey<DCRTPoly>>& secretKeys) const;
+
+    /**
+     * Threshold decryption of many ciphertexts at once. Every key decrypts the
+     * batch in chunks through single MultipartyDecryptLead/Main calls, with the
+     * (key, chunk) pairs spread over the pool. Every finished chunk is folded into
+     * the FusionAccumulator of its ciphertexts right away, so only the decoding
+     * waits for the slowest key.
+     * @param partyIds - ids of the parties holding secretKeys, only used to
+     * attribute the partial decryptions in the trace (see Tracer); 1, 2, ... if empty
+     * @return one plaintext per ciphertext, in input order
+     */
+    std::vector<Plaintext> DecryptBatch(const std::vector<Ciphertext<DCRTPoly>>& ciphertexts,
+                                        const std::vector<PrivateKey<DCRTPoly>>& secretKeys,
+                                        const std::vector<uint32_t>& partyIds = {}) const;
+
+    /**
+     * Rebuilds the secret key of a party that dropped out from the shares held
+     * by the remaining parties.
+     */
+    PrivateKey<DCRTPoly> RecoverKey(const std::unordered_map<uint32_t, DCRTPoly>& shares, usint numParties,
+                                    usint threshold, const std::string& shareType) const;
+
+    /**
+     * Key with which the holder of the Shamir share at index of the joint secret
+     * key takes part in a t-of-N decryption by participants: the share times the
+     * holder's Lagrange coefficient at 0 (computed per RNS tower). The weighted
+     * keys of the participants add up to the joint secret key, so their partial
+     * decryptions fuse to the plaintext without any key being reconstructed.
+     * @param participants - distinct share indices of all decrypting parties, including index
+     */
+    PrivateKey<DCRTPoly> LagrangeWeightedKey(uint32_t index, const DCRTPoly& share,
+                                             const std::vector<uint32_t>& participants) const;
+
+private:
+    CryptoContext<DCRTPoly> cc;
+    ThreadPool& pool;
+};
+
+#endif  //OPENFHE_DECRYPTOR_H
@@ -0,0 +1,42 @@
+#include "encoder.h"
+
+#include <algorithm>
+
+SAEncoder::SAEncoder(const CryptoContext<DCRTPoly>& cc, usint batchSize)
+    : cc(cc), batchSize(batchSize), integer(cc->getSchemeId() != CKKSRNS_SCHEME) {
+    if (batchSize == 0) {
+        OPENFHE_THROW(config_error, "The batch size must be positive");
+    }
+}
+
+Plaintext SAEncoder::Encode(int64_t value) const {
+    return Encode(std::vector<int64_t>{value});
+}
+
+Plaintext SAEncoder::Encode(const std::vector<int64_t>& values, usint offset) const {
+    if (!integer) {
+        return Encode(std::vector<double>(values.begin(), values.end()), offset);
+    }
+    if (offset + values.size() > batchSize) {
+        OPENFHE_THROW(config_error, "SA values do not fit into " + std::to_string(batchSize) + " slots");
+    }
+
+    std::vector<int64_t> slots(batchSize);
+    std::copy(values.begin(), values.end(), slots.begin() + offset);
+    return cc->MakePackedPlaintext(slots);
+}
+
+Plaintext SAEncoder::Encode(const std::vector<double>& values, usint offset) const {
+    if (integer) {
+        OPENFHE_THROW(config_error, "BGV/BFV plaintexts hold integers only");
+    }
+    if (offset + values.size() > batchSize) {
+        OPENFHE_THROW(config_error, "SA values do not fit into " + std::to_string(batchSize) + " slots");
+    }
+
+    std::vector<std::complex<double>> slots(batchSize);
+    for (size_t i = 0; i < values.size(); ++i) {
+        slots[offset + i] = values[i];
+    }
+    return cc->MakeCKKSPackedPlaintext(slots, 1, 0, nullptr, batchSize);
+}
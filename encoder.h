@@ -0,0 +1,51 @@
+#ifndef OPENFHE_ENCODER_H
+#define OPENFHE_ENCODER_H
+
+#include "openfhe.h"
+
+#include <vector>
+
+using namespace lbcrypto;
+
+/**
+ * Encodes SA values straight into CKKS packed plaintexts, or into BGV/BFV
+ * packed plaintexts when cc is an integer scheme.
+ *
+ * The original encoding filled every coefficient of every RNS tower of an
+ * EVALUATION-format DCRTPoly with the value and ran an inverse NTT. The inverse
+ * NTT of a constant vector is the constant polynomial, so the only nonzero
+ * coefficient - and hence the only nonzero slot after truncating to the batch
+ * size - is the value itself in slot 0. This encoder writes that slot directly
+ * and never materializes the ring-dimension polynomial.
+ */
+class SAEncoder {
+public:
+    SAEncoder(const CryptoContext<DCRTPoly>& cc, usint batchSize);
+
+    usint GetBatchSize() const {
+        return batchSize;
+    }
+
+    /**
+     * Value in slot 0, all other slots zero.
+     */
+    Plaintext Encode(int64_t value) const;
+
+    /**
+     * values[i] in slot offset + i, all other slots zero.
+     */
+    Plaintext Encode(const std::vector<int64_t>& values, usint offset = 0) const;
+
+    /**
+     * values[i] in slot offset + i, all other slots zero; CKKS only.
+     */
+    Plaintext Encode(const std::vector<double>& values, usint offset = 0) const;
+
+private:
+    CryptoContext<DCRTPoly> cc;
+    usint batchSize;
+    // BGV/BFV context: exact integer slots instead of CKKS
+    bool integer;
+};
+
+#endif  //OPENFHE_ENCODER_H
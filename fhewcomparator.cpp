@@ -0,0 +1,86 @@
+#include "fhewcomparator.h"
+#include "tracer.h"
+
+#include <cmath>
+
+namespace {
+
+// modulus bits of the FHEW ciphertexts that hold the switched differences
+const uint32_t LOG_Q_FHEW = 25;
+
+// levels of the linear transforms of the two switches: slots to coefficients
+// on the way to FHEW, the homomorphic LWE decryption on the way back
+const uint32_t LEVEL_BUDGET_FROM_CKKS = 1;
+const uint32_t LEVEL_BUDGET_TO_CKKS   = 1;
+
+// the way to FHEW scales the differences into the FHEW plaintext space; the
+// way back evaluates the cosine with a Chebyshev series of depth 9, applies
+// R = 3 double-angle iterations and scales the result (OpenFHE's FHEWtoCKKS)
+const uint32_t PRESCALING_DEPTH  = 1;
+const uint32_t COSINE_DEPTH      = 9;
+const uint32_t DOUBLE_ANGLE_ITER = 3;
+const uint32_t POSTSCALING_DEPTH = 1;
+
+// FLEXIBLEAUTO spends one more level on the first rescaling
+const uint32_t FLEXIBLE_SCALING_DEPTH = 1;
+
+}  // namespace
+
+FhewComparator::FhewComparator(const CryptoContext<DCRTPoly>& cc, const KeyPair<DCRTPoly>& jointKeys,
+                               double lowerBound, double upperBound, uint32_t numValues, uint32_t numSlots,
+                               SecurityLevel securityLevel)
+    : cc(cc),
+      publicKey(jointKeys.publicKey),
+      lowerBound(lowerBound),
+      upperBound(upperBound),
+      numValues(numValues),
+      numSlots(numSlots) {
+    if (!(lowerBound < upperBound)) {
+        OPENFHE_THROW(config_error, "The comparison needs lowerBound < upperBound");
+    }
+    if (numValues == 0 || numValues > numSlots) {
+        OPENFHE_THROW(config_error, "Between 1 and numSlots values can be compared");
+    }
+
+    SchSwchParams params;
+    params.SetSecurityLevelCKKS(securityLevel);
+    params.SetSecurityLevelFHEW(securityLevel == HEStd_NotSet ? TOY : STD128);
+    params.SetCtxtModSizeFHEWLargePrec(LOG_Q_FHEW);
+    params.SetNumSlotsCKKS(numSlots);
+    params.SetNumValues(numValues);
+    params.SetLevelBudgetFromCKKS(LEVEL_BUDGET_FROM_CKKS);
+    params.SetLevelBudgetToCKKS(LEVEL_BUDGET_TO_CKKS);
+    auto privateKeyFHEW = cc->EvalSchemeSwitchingSetup(params);
+    cc->EvalSchemeSwitchingKeyGen(jointKeys, privateKeyFHEW);
+
+    // plaintext modulus of the FHEW sign evaluation; the differences must
+    // stay below half of it to keep their sign
+    const uint32_t beta = cc->GetBinCCForSchemeSwitch()->GetBeta().ConvertToInt();
+    const uint32_t pLWE = (uint32_t(1) << LOG_Q_FHEW) / (2 * beta);
+    if (upperBound - lowerBound + 1 >= pLWE / 2) {
+        OPENFHE_THROW(config_error, "The range [" + std::to_string(lowerBound) + ", " + std::to_string(upperBound) +
+                                        "] exceeds the FHEW plaintext space");
+    }
+    cc->EvalCompareSwitchPrecompute(pLWE);
+}
+
+Ciphertext<DCRTPoly> FhewComparator::EvalGreater(const Ciphertext<DCRTPoly>& ct, double threshold) const {
+    if (threshold < lowerBound || threshold > upperBound) {
+        OPENFHE_THROW(config_error, "Threshold " + std::to_string(threshold) + " is outside [" +
+                                        std::to_string(lowerBound) + ", " + std::to_string(upperBound) + "]");
+    }
+    // the midpoint keeps the CKKS error of integer slots away from a zero difference
+    std::vector<double> midpoint(numSlots, std::floor(threshold) + 0.5);
+    auto midpointCt = cc->Encrypt(publicKey, cc->MakeCKKSPackedPlaintext(midpoint));
+
+    // 1 where midpoint < x, 0 elsewhere
+    auto bits = cc->EvalCompareSchemeSwitching(midpointCt, ct, numValues, numSlots);
+    TraceCount("fhew_comparisons", numValues);
+    return cc->EvalSub(cc->EvalAdd(bits, bits), 1.0);
+}
+
+uint32_t FhewComparator::SwitchingDepth() {
+    // both switches run on one modulus chain; 17 with the budgets above
+    return (PRESCALING_DEPTH + LEVEL_BUDGET_FROM_CKKS) +
+           (LEVEL_BUDGET_TO_CKKS + COSINE_DEPTH + DOUBLE_ANGLE_ITER + POSTSCALING_DEPTH) + FLEXIBLE_SCALING_DEPTH;
+}
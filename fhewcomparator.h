@@ -0,0 +1,57 @@
+#ifndef OPENFHE_FHEWCOMPARATOR_H
+#define OPENFHE_FHEWCOMPARATOR_H
+
+#include "openfhe.h"
+
+using namespace lbcrypto;
+
+/**
+ * Exact threshold check by scheme switching: the leading numValues slots of
+ * the CKKS aggregate minus the threshold are switched to FHEW ciphertexts,
+ * whose signs are computed exactly by FHEW functional bootstrapping, and the
+ * resulting bits are switched back to one CKKS ciphertext under the joint
+ * public key. The result is therefore threshold-decrypted like any other.
+ *
+ * OpenFHE derives the switching keys (CKKS to FHEW key switching, the FHEW
+ * bootstrapping keys and the automorphism keys of the way back) from a single
+ * CKKS secret key and has no multiparty protocol for them. They are generated
+ * from the joint secret key, the sum of the party secrets, which only a dealer
+ * holding all party keys can form; in a deployment that step must run in a
+ * trusted dealer or in MPC. Encryption, aggregation and decryption stay
+ * multiparty.
+ */
+class FhewComparator {
+public:
+    /**
+     * Sets up the FHEW context and generates the switching keys.
+     * @param jointKeys - joint public key and the joint secret key with the same key tag
+     * @param lowerBound, upperBound - range of the inputs x and of the thresholds
+     * @param numValues - leading slots compared per call; each costs one FHEW bootstrapping
+     * @param numSlots - CKKS batch size
+     */
+    FhewComparator(const CryptoContext<DCRTPoly>& cc, const KeyPair<DCRTPoly>& jointKeys, double lowerBound,
+                   double upperBound, uint32_t numValues, uint32_t numSlots, SecurityLevel securityLevel);
+
+    /**
+     * Exactly +1 in each of the leading numValues slots whose integer x is
+     * greater than threshold and -1 in all others, like ComparisonEngine::EvalGreater
+     * against the midpoint floor(threshold) + 0.5.
+     */
+    Ciphertext<DCRTPoly> EvalGreater(const Ciphertext<DCRTPoly>& ct, double threshold) const;
+
+    /**
+     * Multiplicative depth of the switch to FHEW and back with FLEXIBLEAUTO
+     * scaling, derived from the level budgets the comparator configures.
+     */
+    static uint32_t SwitchingDepth();
+
+private:
+    CryptoContext<DCRTPoly> cc;
+    PublicKey<DCRTPoly> publicKey;
+    double lowerBound;
+    double upperBound;
+    uint32_t numValues;
+    uint32_t numSlots;
+};
+
+#endif  //OPENFHE_FHEWCOMPARATOR_H
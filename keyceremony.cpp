@@ -0,0 +1,156 @@
+#include "keyceremony.h"
+#include "tracer.h"
+
+EvalKeyPlan EvalKeyPlan::Missing(const EvalKeyPlan& other) const {
+    EvalKeyPlan missing;
+    missing.mult = other.mult && !mult;
+    missing.sum  = other.sum && !sum;
+    for (int32_t rotation : other.rotations) {
+        if (rotations.count(rotation) == 0) {
+            missing.rotations.insert(rotation);
+        }
+    }
+    return missing;
+}
+
+void EvalKeyPlan::Merge(const EvalKeyPlan& other) {
+    mult = mult || other.mult;
+    sum  = sum || other.sum;
+    rotations.insert(other.rotations.begin(), other.rotations.end());
+}
+
+KeyCeremony::KeyCeremony(const CryptoContext<DCRTPoly>& cc, ThreadPool& pool) : cc(cc), pool(pool) {}
+
+PublicKey<DCRTPoly> KeyCeremony::Run(std::vector<Party>& parties, const EvalKeyPlan& plan) {
+    if (parties.empty()) {
+        OPENFHE_THROW(config_error, "The key ceremony needs at least one party");
+    }
+
+    auto jointPublicKey = GenerateJointPublicKey(parties);
+    // the eval keys are stored under the tag of the joint key
+    GenerateEvalKeys(parties, jointPublicKey->GetKeyTag(), plan);
+    return jointPublicKey;
+}
+
+void KeyCeremony::GenerateEvalKeys(const std::vector<Party>& parties, const std::string& keyTag,
+                                   const EvalKeyPlan& plan) {
+    if (plan.mult) {
+        cc->InsertEvalMultKey({GenerateEvalMultKey(parties, keyTag)});
+    }
+    if (plan.sum) {
+        cc->InsertEvalSumKey(GenerateEvalSumKeys(parties, keyTag));
+    }
+    if (!plan.rotations.empty()) {
+        const std::vector<int32_t> rotations(plan.rotations.begin(), plan.rotations.end());
+        cc->InsertEvalAutomorphismKey(GenerateRotationKeys(parties, keyTag, rotations));
+    }
+}
+
+PublicKey<DCRTPoly> KeyCeremony::GenerateJointPublicKey(std::vector<Party>& parties) {
+    TraceScope scope("joint_public_key");
+    parties[0].GenerateKeys(nullptr);
+    const auto& leadPublicKey = parties[0].GetPublicKey();
+    const std::string keyTag  = leadPublicKey->GetKeyTag();
+
+    pool.ParallelFor(1, parties.size(), [&](size_t i) { parties[i].GenerateKeys(leadPublicKey, true); });
+
+    std::vector<PublicKey<DCRTPoly>> publicKeys;
+    publicKeys.reserve(parties.size());
+    for (const auto& party : parties) {
+        publicKeys.push_back(party.GetPublicKey());
+    }
+
+    return pool.TreeReduce(publicKeys, [&](PublicKey<DCRTPoly>& acc, const PublicKey<DCRTPoly>& other) {
+        acc = cc->MultiAddPubKeys(acc, other, keyTag);
+    });
+}
+
+EvalKey<DCRTPoly> KeyCeremony::GenerateEvalMultKey(const std::vector<Party>& parties, const std::string& keyTag) {
+    TraceScope scope("eval_mult_key");
+    const size_t N  = parties.size();
+    const auto& sk0 = parties[0].GetSecretKey();
+
+    // Round 1: key-switching key parts for s_i, all based on party 1's key
+    std::vector<EvalKey<DCRTPoly>> evalMultKeys(N);
+    evalMultKeys[0] = cc->KeySwitchGen(sk0, sk0);
+    pool.ParallelFor(1, N, [&](size_t i) {
+        TraceScope partyScope("eval_mult_round1", parties[i].GetId());
+        const auto& sk  = parties[i].GetSecretKey();
+        evalMultKeys[i] = cc->MultiKeySwitchGen(sk, sk, evalMultKeys[0]);
+    });
+
+    auto evalMultJoint = pool.TreeReduce(evalMultKeys, [&](EvalKey<DCRTPoly>& acc, const EvalKey<DCRTPoly>& other) {
+        acc = cc->MultiAddEvalKeys(acc, other, keyTag);
+    });
+
+    // Round 2: every party transforms the joint key into s_i * (s_1 + ... + s_N)
+    std::vector<EvalKey<DCRTPoly>> evalMultParts(N);
+    pool.ParallelFor(0, N, [&](size_t i) {
+        TraceScope partyScope("eval_mult_round2", parties[i].GetId());
+        evalMultParts[i] = cc->MultiMultEvalKey(parties[i].GetSecretKey(), evalMultJoint, keyTag);
+    });
+
+    return pool.TreeReduce(evalMultParts, [&](EvalKey<DCRTPoly>& acc, const EvalKey<DCRTPoly>& other) {
+        acc = cc->MultiAddEvalMultKeys(acc, other, keyTag);
+    });
+}
+
+std::shared_ptr<EvalKeyMap> KeyCeremony::GenerateEvalSumKeys(const std::vector<Party>& parties,
+                                                             const std::string& keyTag) {
+    TraceScope scope("eval_sum_keys");
+    const size_t N  = parties.size();
+    const auto& sk0 = parties[0].GetSecretKey();
+
+    std::vector<std::shared_ptr<EvalKeyMap>> evalSumKeys(N);
+    evalSumKeys[0] = LeadAutomorphismKeys(sk0, [&] { cc->EvalSumKeyGen(sk0); });
+    pool.ParallelFor(1, N, [&](size_t i) {
+        TraceScope partyScope("eval_sum_key", parties[i].GetId());
+        evalSumKeys[i] = cc->MultiEvalSumKeyGen(parties[i].GetSecretKey(), evalSumKeys[0], keyTag);
+    });
+
+    return pool.TreeReduce(evalSumKeys,
+                           [&](std::shared_ptr<EvalKeyMap>& acc, const std::shared_ptr<EvalKeyMap>& other) {
+                               acc = cc->MultiAddEvalSumKeys(acc, other, keyTag);
+                           });
+}
+
+std::shared_ptr<EvalKeyMap> KeyCeremony::GenerateRotationKeys(const std::vector<Party>& parties,
+                                                              const std::string& keyTag,
+                                                              const std::vector<int32_t>& rotations) {
+    TraceScope scope("rotation_keys");
+    const size_t N  = parties.size();
+    const auto& sk0 = parties[0].GetSecretKey();
+
+    std::vector<std::shared_ptr<EvalKeyMap>> rotationKeys(N);
+    rotationKeys[0] = LeadAutomorphismKeys(sk0, [&] { cc->EvalAtIndexKeyGen(sk0, rotations); });
+    pool.ParallelFor(1, N, [&](size_t i) {
+        TraceScope partyScope("rotation_key", parties[i].GetId());
+        rotationKeys[i] = cc->MultiEvalAtIndexKeyGen(parties[i].GetSecretKey(), rotationKeys[0], rotations, keyTag);
+    });
+
+    return pool.TreeReduce(rotationKeys,
+                           [&](std::shared_ptr<EvalKeyMap>& acc, const std::shared_ptr<EvalKeyMap>& other) {
+                               acc = cc->MultiAddEvalAutomorphismKeys(acc, other, keyTag);
+                           });
+}
+
+std::shared_ptr<EvalKeyMap> KeyCeremony::LeadAutomorphismKeys(const PrivateKey<DCRTPoly>& sk0,
+                                                              const std::function<void()>& keyGen) {
+    const std::string keyTag = sk0->GetKeyTag();
+    const auto& allKeys      = CryptoContextImpl<DCRTPoly>::GetAllEvalAutomorphismKeys();
+    auto jointKeys           = allKeys.find(keyTag);
+    std::shared_ptr<EvalKeyMap> previous;
+    if (jointKeys != allKeys.end()) {
+        previous = std::make_shared<EvalKeyMap>(*jointKeys->second);
+    }
+    CryptoContextImpl<DCRTPoly>::ClearEvalAutomorphismKeys(keyTag);
+
+    keyGen();
+    auto leadKeys = std::make_shared<EvalKeyMap>(cc->GetEvalAutomorphismKeyMap(keyTag));
+
+    CryptoContextImpl<DCRTPoly>::ClearEvalAutomorphismKeys(keyTag);
+    if (previous != nullptr && !previous->empty()) {
+        cc->InsertEvalAutomorphismKey(previous, keyTag);
+    }
+    return leadKeys;
+}
@@ -0,0 +1,104 @@
+#ifndef OPENFHE_KEYCEREMONY_H
+#define OPENFHE_KEYCEREMONY_H
+
+#include "openfhe.h"
+
+#include "party.h"
+#include "threadpool.h"
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace lbcrypto;
+
+using EvalKeyMap = std::map<usint, EvalKey<DCRTPoly>>;
+
+/**
+ * Set of joint eval keys: the relinearization key, the EvalSum keys over the
+ * batch and individual EvalAtIndex rotations. EvalSum keys are log2(batch)
+ * automorphism keys, the largest key material of the ceremony, so a
+ * computation should only ask for what it runs (see SchemeSwitchPipeline::GetEvalKeyPlan).
+ */
+struct EvalKeyPlan {
+    bool mult = false;
+    bool sum  = false;
+    std::set<int32_t> rotations;
+
+    bool IsEmpty() const {
+        return !mult && !sum && rotations.empty();
+    }
+
+    /**
+     * Keys of other that this plan does not hold.
+     */
+    EvalKeyPlan Missing(const EvalKeyPlan& other) const;
+
+    void Merge(const EvalKeyPlan& other);
+};
+
+/**
+ * Joint key generation for N parties. Every party's contribution only depends
+ * on the lead party's (party 1) key material, so the per-party steps run
+ * concurrently and the contributions are summed with a balanced reduction tree
+ * (depth ceil(log2(N)) instead of the N - 1 sequential additions of a chain).
+ */
+class KeyCeremony {
+public:
+    KeyCeremony(const CryptoContext<DCRTPoly>& cc, ThreadPool& pool);
+
+    /**
+     * Runs the whole ceremony: joint public key and the eval keys of plan,
+     * which are inserted into the crypto context.
+     * @return the joint public key
+     */
+    PublicKey<DCRTPoly> Run(std::vector<Party>& parties, const EvalKeyPlan& plan);
+
+    /**
+     * Party 1 runs KeyGen, the others derive fresh keys from its public key in
+     * parallel; the public keys are then summed with MultiAddPubKeys. The joint
+     * key carries party 1's key tag.
+     */
+    PublicKey<DCRTPoly> GenerateJointPublicKey(std::vector<Party>& parties);
+
+    /**
+     * Relinearization key for (s_1 + ... + s_N)^2.
+     */
+    EvalKey<DCRTPoly> GenerateEvalMultKey(const std::vector<Party>& parties, const std::string& keyTag);
+
+    /**
+     * Rotation keys needed by EvalSum, for the joint secret.
+     */
+    std::shared_ptr<EvalKeyMap> GenerateEvalSumKeys(const std::vector<Party>& parties, const std::string& keyTag);
+
+    /**
+     * EvalAtIndex keys for the given rotations, for the joint secret.
+     */
+    std::shared_ptr<EvalKeyMap> GenerateRotationKeys(const std::vector<Party>& parties, const std::string& keyTag,
+                                                     const std::vector<int32_t>& rotations);
+
+    /**
+     * Generates the eval keys of plan for the joint key keyTag and inserts
+     * them into the crypto context; an empty plan costs nothing.
+     */
+    void GenerateEvalKeys(const std::vector<Party>& parties, const std::string& keyTag, const EvalKeyPlan& plan);
+
+private:
+    /**
+     * Party 1's own automorphism keys from keyGen, which inserts them under
+     * party 1's key tag. That tag is the joint one, and inserting never replaces
+     * existing indices, so the joint keys of earlier ceremonies are set aside
+     * while keyGen runs and restored afterwards; the tag then holds no keys of
+     * party 1 that would shadow the joint keys inserted next.
+     */
+    std::shared_ptr<EvalKeyMap> LeadAutomorphismKeys(const PrivateKey<DCRTPoly>& sk0,
+                                                     const std::function<void()>& keyGen);
+
+    CryptoContext<DCRTPoly> cc;
+    ThreadPool& pool;
+};
+
+#endif  //OPENFHE_KEYCEREMONY_H
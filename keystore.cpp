@@ -0,0 +1,272 @@
+#include "keystore.h"
+
+// header files needed for serialization
+#include "ciphertext-ser.h"
+#include "cryptocontext-ser.h"
+#include "key/key-ser.h"
+#include "scheme/bfvrns/bfvrns-ser.h"
+#include "scheme/bgvrns/bgvrns-ser.h"
+#include "scheme/ckksrns/ckksrns-ser.h"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const char MANIFEST[] = "manifest.txt";
+
+std::ofstream OpenForWrite(const std::string& path) {
+    std::ofstream ofs(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!ofs.is_open()) {
+        OPENFHE_THROW(openfhe_error, "Cannot open " + path + " for writing");
+    }
+    return ofs;
+}
+
+std::ifstream OpenForRead(const std::string& path) {
+    std::ifstream ifs(path, std::ios::in | std::ios::binary);
+    if (!ifs.is_open()) {
+        OPENFHE_THROW(openfhe_error, "Cannot open " + path + " for reading");
+    }
+    return ifs;
+}
+
+}  // namespace
+
+KeyStore::KeyStore(const std::string& directory) : directory(directory) {}
+
+std::string KeyStore::Path(const std::string& name) const {
+    return (fs::path(directory) / name).string();
+}
+
+std::string KeyStore::PartyFile(usint id, const std::string& suffix) {
+    return "party" + std::to_string(id) + "-" + suffix + ".bin";
+}
+
+std::string KeyStore::Fingerprint(const PipelineParams& params) {
+    std::ostringstream ss;
+    ss << "parties=" << params.numParties << " batch=" << params.batchSize << " depth=" << params.multDepth
+       << " scalemod=" << params.scalingModSize << " security=" << params.securityLevel
+       << " fault=" << params.faultTolerant << " share=" << params.shareType
+       << " tofn=" << params.thresholdDecryption << " ringdim=" << params.ringDim
+       << " keyswitch=" << params.keySwitchTechnique << " tparties=" << params.thresholdParties
+       << " comparison=" << params.comparison << " signiter=" << params.signIterations
+       << " degree=" << params.polyDegree;
+    // the plaintext modulus of the integer schemes depends on the value bounds
+    if (params.scheme != "ckks") {
+        ss << " scheme=" << params.scheme << " max=" << params.maxValue << " bound=" << params.upperBound;
+    }
+    return ss.str();
+}
+
+bool KeyStore::IsValidFor(const PipelineParams& params) const {
+    std::ifstream manifest(Path(MANIFEST));
+    if (!manifest.is_open()) {
+        return false;
+    }
+
+    std::string key;
+    uint32_t version = 0;
+    std::string fingerprint;
+    manifest >> key >> version;
+    if (key != "version" || version != VERSION) {
+        return false;
+    }
+    manifest >> key >> std::ws;
+    std::getline(manifest, fingerprint);
+    return key == "params" && fingerprint == Fingerprint(params);
+}
+
+EvalKeyPlan KeyStore::ReadEvalKeys() const {
+    std::ifstream manifest(Path(MANIFEST));
+    std::string line;
+    std::getline(manifest, line);
+    std::getline(manifest, line);
+
+    EvalKeyPlan evalKeys;
+    std::string key;
+    size_t numRotations = 0;
+    manifest >> key >> evalKeys.mult >> evalKeys.sum >> numRotations;
+    for (size_t i = 0; i < numRotations; ++i) {
+        int32_t rotation = 0;
+        manifest >> rotation;
+        evalKeys.rotations.insert(rotation);
+    }
+    if (!manifest || key != "evalkeys") {
+        OPENFHE_THROW(openfhe_error, "Malformed eval key list in the key store manifest in " + directory);
+    }
+    return evalKeys;
+}
+
+void KeyStore::Save(const PipelineParams& params, const CryptoContext<DCRTPoly>& cc,
+                    const PublicKey<DCRTPoly>& jointPublicKey, const std::vector<Party>& parties,
+                    const EvalKeyPlan& evalKeys) const {
+    fs::create_directories(directory);
+    // invalidate the old store while it is being overwritten
+    fs::remove(Path(MANIFEST));
+
+    const std::string keyTag = jointPublicKey->GetKeyTag();
+
+    if (!Serial::SerializeToFile(Path("cryptocontext.bin"), cc, SerType::BINARY)) {
+        OPENFHE_THROW(openfhe_error, "Error writing the crypto context to " + directory);
+    }
+    if (!Serial::SerializeToFile(Path("publickey.bin"), jointPublicKey, SerType::BINARY)) {
+        OPENFHE_THROW(openfhe_error, "Error writing the joint public key to " + directory);
+    }
+
+    // the manifest lists the eval keys; drop those of an earlier store it would not list
+    fs::remove(Path("evalmultkey.bin"));
+    fs::remove(Path("automorphismkey.bin"));
+    if (evalKeys.mult) {
+        auto ofs = OpenForWrite(Path("evalmultkey.bin"));
+        if (!cc->SerializeEvalMultKey(ofs, SerType::BINARY, keyTag)) {
+            OPENFHE_THROW(openfhe_error, "Error writing the eval-mult key to " + directory);
+        }
+    }
+    if (evalKeys.sum || !evalKeys.rotations.empty()) {
+        // EvalSum and EvalAtIndex keys both live in the automorphism key map
+        auto ofs = OpenForWrite(Path("automorphismkey.bin"));
+        if (!cc->SerializeEvalAutomorphismKey(ofs, SerType::BINARY, keyTag)) {
+            OPENFHE_THROW(openfhe_error, "Error writing the automorphism keys to " + directory);
+        }
+    }
+
+    for (const auto& party : parties) {
+        {
+            auto ofs = OpenForWrite(Path(PartyFile(party.GetId(), "keypair")));
+            Serial::Serialize(party.GetPublicKey(), ofs, SerType::BINARY);
+            Serial::Serialize(party.GetSecretKey(), ofs, SerType::BINARY);
+        }
+
+        if (party.HasJointKeyShare()) {
+            auto ofs = OpenForWrite(Path(PartyFile(party.GetId(), "jointshare")));
+            Serial::Serialize(party.GetJointKeyShare(), ofs, SerType::BINARY);
+            if (!ofs) {
+                OPENFHE_THROW(openfhe_error,
+                              "Error writing the joint key share of party " + std::to_string(party.GetId()));
+            }
+        }
+
+        const auto& shares = party.GetKeyShares();
+        if (shares.empty()) {
+            continue;
+        }
+        auto ofs           = OpenForWrite(Path(PartyFile(party.GetId(), "shares")));
+        uint32_t numShares = shares.size();
+        ofs.write(reinterpret_cast<const char*>(&numShares), sizeof(numShares));
+        for (const auto& [index, share] : shares) {
+            ofs.write(reinterpret_cast<const char*>(&index), sizeof(index));
+            Serial::Serialize(share, ofs, SerType::BINARY);
+        }
+        if (!ofs) {
+            OPENFHE_THROW(openfhe_error, "Error writing the key shares of party " + std::to_string(party.GetId()));
+        }
+    }
+
+    // manifest last, via rename so that it is either complete or absent
+    {
+        std::ofstream manifest(Path("manifest.tmp"), std::ios::out | std::ios::trunc);
+        manifest << "version " << VERSION << "\n";
+        manifest << "params " << Fingerprint(params) << "\n";
+        manifest << "evalkeys " << evalKeys.mult << " " << evalKeys.sum << " " << evalKeys.rotations.size();
+        for (int32_t rotation : evalKeys.rotations) {
+            manifest << " " << rotation;
+        }
+        manifest << "\n";
+        if (!manifest) {
+            OPENFHE_THROW(openfhe_error, "Error writing the key store manifest to " + directory);
+        }
+    }
+    fs::rename(Path("manifest.tmp"), Path(MANIFEST));
+}
+
+bool KeyStore::Load(const PipelineParams& params, CryptoContext<DCRTPoly>& cc, PublicKey<DCRTPoly>& jointPublicKey,
+                    std::vector<Party>& parties, EvalKeyPlan& evalKeys) const {
+    if (!IsValidFor(params)) {
+        return false;
+    }
+    const EvalKeyPlan storedEvalKeys = ReadEvalKeys();
+
+    CryptoContext<DCRTPoly> loadedCC;
+    if (!Serial::DeserializeFromFile(Path("cryptocontext.bin"), loadedCC, SerType::BINARY)) {
+        OPENFHE_THROW(openfhe_error, "Error reading the crypto context from " + directory);
+    }
+    PublicKey<DCRTPoly> loadedPublicKey;
+    if (!Serial::DeserializeFromFile(Path("publickey.bin"), loadedPublicKey, SerType::BINARY)) {
+        OPENFHE_THROW(openfhe_error, "Error reading the joint public key from " + directory);
+    }
+
+    // the eval key maps are global; drop only the keys of an earlier load of
+    // this store, which the deserialized ones would not replace, and leave
+    // those of the other contexts in the process alone
+    const std::string keyTag = loadedPublicKey->GetKeyTag();
+    CryptoContextImpl<DCRTPoly>::ClearEvalMultKeys(keyTag);
+    CryptoContextImpl<DCRTPoly>::ClearEvalAutomorphismKeys(keyTag);
+
+    if (storedEvalKeys.mult) {
+        auto ifs = OpenForRead(Path("evalmultkey.bin"));
+        if (!CryptoContextImpl<DCRTPoly>::DeserializeEvalMultKey(ifs, SerType::BINARY)) {
+            OPENFHE_THROW(openfhe_error, "Error reading the eval-mult key from " + directory);
+        }
+    }
+    if (storedEvalKeys.sum || !storedEvalKeys.rotations.empty()) {
+        auto ifs = OpenForRead(Path("automorphismkey.bin"));
+        if (!CryptoContextImpl<DCRTPoly>::DeserializeEvalAutomorphismKey(ifs, SerType::BINARY)) {
+            OPENFHE_THROW(openfhe_error, "Error reading the automorphism keys from " + directory);
+        }
+    }
+
+    std::vector<Party> loadedParties;
+    loadedParties.reserve(params.numParties);
+    for (usint i = 0; i < params.numParties; ++i) {
+        Party party(i + 1, loadedCC);
+
+        {
+            auto ifs = OpenForRead(Path(PartyFile(party.GetId(), "keypair")));
+            KeyPair<DCRTPoly> keyPair;
+            Serial::Deserialize(keyPair.publicKey, ifs, SerType::BINARY);
+            Serial::Deserialize(keyPair.secretKey, ifs, SerType::BINARY);
+            party.SetKeyPair(keyPair);
+        }
+
+        const std::string jointSharePath = Path(PartyFile(party.GetId(), "jointshare"));
+        if (fs::exists(jointSharePath)) {
+            auto ifs = OpenForRead(jointSharePath);
+            DCRTPoly jointShare;
+            Serial::Deserialize(jointShare, ifs, SerType::BINARY);
+            if (!ifs) {
+                OPENFHE_THROW(openfhe_error,
+                              "Error reading the joint key share of party " + std::to_string(party.GetId()));
+            }
+            party.SetJointKeyShare(jointShare);
+        }
+
+        const std::string sharesPath = Path(PartyFile(party.GetId(), "shares"));
+        if (fs::exists(sharesPath)) {
+            auto ifs           = OpenForRead(sharesPath);
+            uint32_t numShares = 0;
+            ifs.read(reinterpret_cast<char*>(&numShares), sizeof(numShares));
+            std::unordered_map<uint32_t, DCRTPoly> shares;
+            for (uint32_t j = 0; j < numShares; ++j) {
+                uint32_t index = 0;
+                ifs.read(reinterpret_cast<char*>(&index), sizeof(index));
+                Serial::Deserialize(shares[index], ifs, SerType::BINARY);
+            }
+            if (!ifs) {
+                OPENFHE_THROW(openfhe_error, "Error reading the key shares of party " + std::to_string(party.GetId()));
+            }
+            party.SetKeyShares(shares);
+        }
+
+        loadedParties.push_back(std::move(party));
+    }
+
+    cc             = loadedCC;
+    jointPublicKey = loadedPublicKey;
+    parties        = std::move(loadedParties);
+    evalKeys       = storedEvalKeys;
+    return true;
+}
@@ -0,0 +1,78 @@
+#ifndef OPENFHE_KEYSTORE_H
+#define OPENFHE_KEYSTORE_H
+
+#include "openfhe.h"
+
+#include "party.h"
+#include "pipeline.h"
+
+#include <string>
+#include <vector>
+
+using namespace lbcrypto;
+
+/**
+ * Versioned on-disk cache of the key material produced by the key ceremony:
+ * crypto context, joint public key, the joint eval keys generated so far and, per party,
+ * the key pair, the Shamir shares of its secret key and its share of the joint
+ * key. Loading it lets a run skip context generation and the whole ceremony.
+ *
+ * Layout of the store directory:
+ *   manifest.txt                       format version, the parameters it was generated for and
+ *                                      the eval keys it holds (see EvalKeyPlan)
+ *   cryptocontext.bin, publickey.bin   crypto context and joint public key
+ *   evalmultkey.bin                    joint eval-mult key, if generated
+ *   automorphismkey.bin                joint EvalSum and EvalAtIndex keys, if generated
+ *   party<i>-keypair.bin               party i's public and secret key
+ *   party<i>-shares.bin                shares of party i's secret key (fault tolerant mode)
+ *   party<i>-jointshare.bin            party i's Shamir share of the joint secret key (t-of-N mode)
+ *
+ * The manifest is written last, so an interrupted Save() is never picked up by Load().
+ */
+class KeyStore {
+public:
+    // bump whenever the layout or the serialization of one of the files changes
+    static constexpr uint32_t VERSION = 5;
+
+    explicit KeyStore(const std::string& directory);
+
+    const std::string& GetDirectory() const {
+        return directory;
+    }
+
+    /**
+     * True if the directory holds a complete store of the current version
+     * generated for params.
+     */
+    bool IsValidFor(const PipelineParams& params) const;
+
+    /**
+     * Writes all key material, with the eval keys listed in evalKeys; throws
+     * openfhe_error if a file cannot be written.
+     */
+    void Save(const PipelineParams& params, const CryptoContext<DCRTPoly>& cc,
+              const PublicKey<DCRTPoly>& jointPublicKey, const std::vector<Party>& parties,
+              const EvalKeyPlan& evalKeys) const;
+
+    /**
+     * Loads the key material if the store is valid for params (see IsValidFor),
+     * rebuilding the parties, and sets evalKeys to the eval keys it held.
+     * Returns false and leaves the outputs untouched otherwise.
+     */
+    bool Load(const PipelineParams& params, CryptoContext<DCRTPoly>& cc, PublicKey<DCRTPoly>& jointPublicKey,
+              std::vector<Party>& parties, EvalKeyPlan& evalKeys) const;
+
+private:
+    std::string Path(const std::string& name) const;
+
+    static std::string PartyFile(usint id, const std::string& suffix);
+
+    static std::string Fingerprint(const PipelineParams& params);
+
+    // the eval keys listed in the manifest
+    EvalKeyPlan ReadEvalKeys() const;
+
+    std::string directory;
+};
+
+#endif  //OPENFHE_KEYSTORE_H
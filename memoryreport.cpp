@@ -0,0 +1,200 @@
+#include "memoryreport.h"
+
+// header files needed for serialization
+#include "ciphertext-ser.h"
+#include "key/key-ser.h"
+#include "scheme/bfvrns/bfvrns-ser.h"
+#include "scheme/bgvrns/bgvrns-ser.h"
+#include "scheme/ckksrns/ckksrns-ser.h"
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+
+// phases currently open; only the outermost one is recorded
+std::atomic<int> openPhases{0};
+
+// value in bytes of a "<key>: <n> kB" line of /proc/self/status
+uint64_t StatusBytes(const std::string& key) {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, key.size(), key) == 0 && line.size() > key.size() && line[key.size()] == ':') {
+            return std::strtoull(line.c_str() + key.size() + 1, nullptr, 10) * 1024;
+        }
+    }
+    return 0;
+}
+
+template <typename T>
+uint64_t SerializedBytes(const T& object) {
+    std::ostringstream os;
+    Serial::Serialize(object, os, SerType::BINARY);
+    return os.tellp();
+}
+
+uint64_t InMemorySize(const std::vector<DCRTPoly>& polys) {
+    uint64_t bytes = 0;
+    for (const DCRTPoly& poly : polys) {
+        bytes += MemoryReport::InMemoryBytes(poly);
+    }
+    return bytes;
+}
+
+uint64_t InMemorySize(const EvalKey<DCRTPoly>& key) {
+    return InMemorySize(key->GetAVector()) + InMemorySize(key->GetBVector());
+}
+
+double MiB(uint64_t bytes) {
+    return bytes / (1024.0 * 1024.0);
+}
+
+}  // namespace
+
+void MemoryReport::Reset() {
+    std::lock_guard<std::mutex> lock(mtx);
+    items.clear();
+    phases.clear();
+}
+
+void MemoryReport::Record(const std::string& name, size_t count, uint64_t serializedBytes, uint64_t inMemoryBytes) {
+    std::lock_guard<std::mutex> lock(mtx);
+    items[name] = {count, serializedBytes, inMemoryBytes};
+}
+
+void MemoryReport::RecordKeyMaterial(const CryptoContext<DCRTPoly>& cc, const PublicKey<DCRTPoly>& jointPublicKey,
+                                     const std::vector<Party>& parties) {
+    if (!IsEnabled()) {
+        return;
+    }
+    const std::string keyTag = jointPublicKey->GetKeyTag();
+    Record("joint public key", 1, SerializedBytes(jointPublicKey), InMemorySize(jointPublicKey->GetPublicElements()));
+
+    const auto& multKeys = cc->GetAllEvalMultKeys();
+    auto multKey         = multKeys.find(keyTag);
+    if (multKey != multKeys.end() && !multKey->second.empty()) {
+        const EvalKey<DCRTPoly>& key = multKey->second[0];
+        Record("eval mult key", multKey->second.size(), SerializedBytes(key), InMemorySize(key));
+    }
+
+    // EvalSum and EvalAtIndex keys are both automorphism keys
+    const auto& automorphismKeys = cc->GetAllEvalAutomorphismKeys();
+    auto automorphismKey         = automorphismKeys.find(keyTag);
+    if (automorphismKey != automorphismKeys.end() && !automorphismKey->second->empty()) {
+        uint64_t serializedBytes = 0, inMemoryBytes = 0;
+        for (const auto& [index, key] : *automorphismKey->second) {
+            serializedBytes += SerializedBytes(key);
+            inMemoryBytes += InMemorySize(key);
+        }
+        const size_t count = automorphismKey->second->size();
+        Record("automorphism key", count, serializedBytes / count, inMemoryBytes / count);
+    }
+
+    if (parties.empty() || parties[0].GetSecretKey() == nullptr) {
+        return;
+    }
+    const Party& party = parties[0];
+    Record("party public key", parties.size(), SerializedBytes(party.GetPublicKey()),
+           InMemorySize(party.GetPublicKey()->GetPublicElements()));
+    Record("party secret key", parties.size(), SerializedBytes(party.GetSecretKey()),
+           InMemoryBytes(party.GetSecretKey()->GetPrivateElement()));
+    if (!party.GetKeyShares().empty()) {
+        const DCRTPoly& share = party.GetKeyShares().begin()->second;
+        Record("key share", parties.size() * party.GetKeyShares().size(), SerializedBytes(share),
+               InMemoryBytes(share));
+    }
+    if (party.HasJointKeyShare()) {
+        Record("joint key share", parties.size(), SerializedBytes(party.GetJointKeyShare()),
+               InMemoryBytes(party.GetJointKeyShare()));
+    }
+}
+
+void MemoryReport::RecordCiphertext(const std::string& name, const Ciphertext<DCRTPoly>& ciphertext, size_t count) {
+    if (!IsEnabled() || ciphertext == nullptr) {
+        return;
+    }
+    Record(name, count, SerializedBytes(ciphertext), InMemorySize(ciphertext->GetElements()));
+}
+
+void MemoryReport::RecordPhase(const PhaseMemory& phase) {
+    std::lock_guard<std::mutex> lock(mtx);
+    phases.push_back(phase);
+}
+
+std::map<std::string, MemoryItem> MemoryReport::GetItems() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return items;
+}
+
+std::vector<PhaseMemory> MemoryReport::GetPhases() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return phases;
+}
+
+void MemoryReport::WriteReport(std::ostream& os) const {
+    const auto itemsCopy  = GetItems();
+    const auto phasesCopy = GetPhases();
+
+    const std::ios_base::fmtflags flags = os.flags();
+    os << std::fixed << std::setprecision(2);
+    os << std::left << std::setw(20) << "class" << std::right << std::setw(8) << "count" << std::setw(16)
+       << "serialized B" << std::setw(16) << "in memory B" << std::setw(14) << "total MiB" << std::endl;
+    uint64_t total = 0;
+    for (const auto& [name, item] : itemsCopy) {
+        os << std::left << std::setw(20) << name << std::right << std::setw(8) << item.count << std::setw(16)
+           << item.serializedBytes << std::setw(16) << item.inMemoryBytes << std::setw(14)
+           << MiB(item.count * item.inMemoryBytes) << std::endl;
+        total += item.count * item.inMemoryBytes;
+    }
+    os << std::left << std::setw(60) << "total" << std::right << std::setw(14) << MiB(total) << std::endl;
+
+    os << std::endl
+       << std::left << std::setw(20) << "phase" << std::right << std::setw(14) << "RSS before" << std::setw(14)
+       << "RSS after" << std::setw(14) << "peak MiB" << std::endl;
+    for (const PhaseMemory& phase : phasesCopy) {
+        os << std::left << std::setw(20) << phase.phase << std::right << std::setw(14) << MiB(phase.rssBeforeBytes)
+           << std::setw(14) << MiB(phase.rssAfterBytes) << std::setw(14) << MiB(phase.peakRssBytes)
+           << (phase.peakIsPhaseLocal ? "" : " (process peak)") << std::endl;
+    }
+    os.flags(flags);
+}
+
+uint64_t MemoryReport::CurrentRss() {
+    return StatusBytes("VmRSS");
+}
+
+uint64_t MemoryReport::PeakRss() {
+    return StatusBytes("VmHWM");
+}
+
+bool MemoryReport::ResetPeakRss() {
+    std::ofstream clearRefs("/proc/self/clear_refs");
+    clearRefs << "5";
+    clearRefs.flush();
+    return clearRefs.good();
+}
+
+uint64_t MemoryReport::InMemoryBytes(const DCRTPoly& poly) {
+    return uint64_t(poly.GetNumOfElements()) * poly.GetRingDimension() * sizeof(uint64_t);
+}
+
+void MemoryPhase::Begin(const char* name) {
+    if (openPhases.fetch_add(1) > 0) {
+        // nested: the outer phase measures it
+        openPhases.fetch_sub(1);
+        return;
+    }
+    active                 = true;
+    phase.phase            = name;
+    phase.rssBeforeBytes   = MemoryReport::CurrentRss();
+    phase.peakIsPhaseLocal = MemoryReport::ResetPeakRss();
+}
+
+void MemoryPhase::End() {
+    phase.rssAfterBytes = MemoryReport::CurrentRss();
+    phase.peakRssBytes  = MemoryReport::PeakRss();
+    MemoryReport::Global().RecordPhase(phase);
+    openPhases.fetch_sub(1);
+}
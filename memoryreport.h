@@ -0,0 +1,153 @@
+#ifndef OPENFHE_MEMORYREPORT_H
+#define OPENFHE_MEMORYREPORT_H
+
+#include "openfhe.h"
+
+#include "party.h"
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+using namespace lbcrypto;
+
+/**
+ * Size of one class of key or ciphertext material, e.g. all party ciphertexts.
+ * The sizes are per instance; in-memory sizes count the polynomial coefficients
+ * only (8 bytes per coefficient and RNS tower), which dominate every object.
+ */
+struct MemoryItem {
+    size_t count             = 0;
+    uint64_t serializedBytes = 0;
+    uint64_t inMemoryBytes   = 0;
+};
+
+/**
+ * Resident set size around one pipeline phase (see MemoryPhase). peakRssBytes
+ * is the peak during the phase if the kernel supports resetting the peak,
+ * otherwise the process-wide peak so far (peakIsPhaseLocal false).
+ */
+struct PhaseMemory {
+    std::string phase;
+    uint64_t rssBeforeBytes = 0;
+    uint64_t rssAfterBytes  = 0;
+    uint64_t peakRssBytes   = 0;
+    bool peakIsPhaseLocal   = false;
+};
+
+/**
+ * Process-wide memory accounting: sizes of the key and ciphertext classes the
+ * pipeline holds (RecordKeyMaterial, RecordCiphertext) and peak RSS per
+ * pipeline phase. Disabled by default; while disabled, phases and records cost
+ * one relaxed atomic load. Peak RSS comes from VmHWM in /proc/self/status,
+ * which is reset at the start of every phase through /proc/self/clear_refs.
+ */
+class MemoryReport {
+public:
+    static MemoryReport& Global() {
+        static MemoryReport report;
+        return report;
+    }
+
+    void Enable(bool enable) {
+        enabled.store(enable, std::memory_order_relaxed);
+    }
+
+    bool IsEnabled() const {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Drops all records and phases.
+     */
+    void Reset();
+
+    /**
+     * Records the joint public key, the joint eval-mult and automorphism
+     * (EvalSum/EvalAtIndex) keys stored in cc under its tag, and every party's
+     * key pair, Shamir shares and joint key share.
+     */
+    void RecordKeyMaterial(const CryptoContext<DCRTPoly>& cc, const PublicKey<DCRTPoly>& jointPublicKey,
+                           const std::vector<Party>& parties);
+
+    /**
+     * Records count live ciphertexts of the class name, sized after ciphertext.
+     * A later record of the same class replaces the earlier one.
+     */
+    void RecordCiphertext(const std::string& name, const Ciphertext<DCRTPoly>& ciphertext, size_t count);
+
+    void RecordPhase(const PhaseMemory& phase);
+
+    std::map<std::string, MemoryItem> GetItems() const;
+
+    std::vector<PhaseMemory> GetPhases() const;
+
+    /**
+     * Table of the recorded classes (count, serialized and in-memory size per
+     * instance, total in memory) followed by the RSS per phase.
+     */
+    void WriteReport(std::ostream& os) const;
+
+    /**
+     * Current and peak resident set size of the process; 0 where /proc is not available.
+     */
+    static uint64_t CurrentRss();
+
+    static uint64_t PeakRss();
+
+    /**
+     * Restarts the peak RSS measurement at the current RSS (Linux 4.0 and later).
+     * @return false if the kernel does not support it
+     */
+    static bool ResetPeakRss();
+
+    static uint64_t InMemoryBytes(const DCRTPoly& poly);
+
+private:
+    MemoryReport() = default;
+
+    void Record(const std::string& name, size_t count, uint64_t serializedBytes, uint64_t inMemoryBytes);
+
+    std::atomic<bool> enabled{false};
+
+    mutable std::mutex mtx;
+    std::map<std::string, MemoryItem> items;
+    std::vector<PhaseMemory> phases;
+};
+
+/**
+ * Records the RSS around its scope as a phase of the global memory report, if
+ * the report is enabled. Phases nested in another phase are not recorded, as
+ * resetting the peak would cut the outer phase's measurement short.
+ */
+class MemoryPhase {
+public:
+    explicit MemoryPhase(const char* name) {
+        if (MemoryReport::Global().IsEnabled()) {
+            Begin(name);
+        }
+    }
+
+    ~MemoryPhase() {
+        if (active) {
+            End();
+        }
+    }
+
+    MemoryPhase(const MemoryPhase&)            = delete;
+    MemoryPhase& operator=(const MemoryPhase&) = delete;
+
+private:
+    void Begin(const char* name);
+
+    void End();
+
+    bool active = false;
+    PhaseMemory phase;
+};
+
+#endif  //OPENFHE_MEMORYREPORT_H
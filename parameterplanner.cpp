@@ -0,0 +1,191 @@
+#include "parameterplanner.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace {
+
+const uint32_t FIRST_MOD_BITS   = 60;
+const uint32_t MIN_SCALING_BITS = 30;
+const uint32_t MAX_SCALING_BITS = 55;
+const uint32_t MAX_ITERATIONS   = 4;
+
+// The absolute error of threshold-decrypted results of the shallow sign
+// circuit at scale 2^s is about 2^(ERROR_BITS - s): every partial decryption
+// adds OpenFHE's fixed multiparty flooding noise of standard deviation 2^20
+// (NoiseFlooding::MP_SD), which dwarfs the encryption and rescaling errors of
+// a few levels (about sigma * sqrt(ringDim) < 2^12 for ring dimensions up to
+// 2^15).
+const int ERROR_BITS = 20;
+// The noise of n partials adds up to sqrt(n) * 2^20. A margin of 8 such units
+// keeps at least 3.5 standard deviations for up to 5 parties, the simulation's
+// default; Validate() measures the actual margin for larger party counts.
+const double SAFETY_FACTOR = 8;
+
+// largest log2(QP) per ring dimension 2^10 ... 2^15 for uniform ternary
+// secrets, from the HE security standard (as used by OpenFHE)
+const uint32_t MAX_LOGQ_128[] = {27, 54, 109, 218, 438, 881};
+const uint32_t MAX_LOGQ_192[] = {19, 37, 75, 152, 305, 611};
+const uint32_t MAX_LOGQ_256[] = {14, 29, 58, 118, 237, 476};
+
+double SignPolynomial(double z) {
+    return (2126.0 * z - 1359.0 * z * z * z) / 1024;
+}
+
+template <typename F>
+double TimeMs(F&& f) {
+    auto start = std::chrono::high_resolution_clock::now();
+    f();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+}  // namespace
+
+ParameterPlanner::ParameterPlanner(const Workload& workload) : workload(workload) {
+    if (workload.numParties < 2) {
+        OPENFHE_THROW(config_error, "The SA to FHE conversion needs at least 2 parties");
+    }
+    if (workload.maxValue <= 0) {
+        OPENFHE_THROW(config_error, "The largest party value must be positive");
+    }
+    if (workload.precision < 1) {
+        OPENFHE_THROW(config_error, "Aggregates are integers; the comparison precision must be at least 1");
+    }
+}
+
+PipelineParams ParameterPlanner::Plan() const {
+    const double upperBound = double(workload.maxValue) * workload.numParties;
+
+    // EvalGreater compares against floor(threshold) + 0.5 and normalizes by
+    // the range plus one, so the closest aggregate ends up this far from zero
+    const double distance = (std::ceil(workload.precision) - 0.5) / (upperBound + 1);
+
+    uint32_t iterations  = 0;
+    uint32_t scalingBits = 0;
+    double margin        = distance;
+    while (scalingBits == 0) {
+        if (++iterations > MAX_ITERATIONS) {
+            OPENFHE_THROW(config_error, "No sign approximation resolves the precision over this range");
+        }
+        margin = SignPolynomial(margin);
+        for (uint32_t s = MIN_SCALING_BITS; s <= MAX_SCALING_BITS; ++s) {
+            if (margin >= SAFETY_FACTOR * std::ldexp(1.0, ERROR_BITS - int(s))) {
+                scalingBits = s;
+                break;
+            }
+        }
+    }
+    const usint depth = ComparisonEngine::SignDepth(iterations);
+
+    // CKKS packs ringDim / 2 slots
+    const usint minRingDim = std::max<usint>(1024, 2 * workload.batchSize);
+    const usint hybridRingDim =
+        MinRingDimension(EstimateModulusBits(depth, scalingBits, HYBRID), workload.securityLevel, minRingDim);
+    const usint bvRingDim =
+        MinRingDimension(EstimateModulusBits(depth, scalingBits, BV), workload.securityLevel, minRingDim);
+
+    PipelineParams params;
+    params.numParties         = workload.numParties;
+    params.batchSize          = workload.batchSize;
+    params.securityLevel      = workload.securityLevel;
+    params.multDepth          = depth;
+    params.scalingModSize     = scalingBits;
+    params.keySwitchTechnique = (bvRingDim < hybridRingDim) ? BV : HYBRID;
+    params.thresholdParties   = workload.numParties;
+    params.comparison         = "sign";
+    params.signIterations     = iterations;
+    params.lowerBound         = 0;
+    params.upperBound         = upperBound;
+    params.maxValue           = workload.maxValue;
+    // with a security level OpenFHE picks the same minimum itself from the
+    // exact modulus; without one the ring dimension has to be given
+    if (workload.securityLevel == HEStd_NotSet) {
+        params.ringDim = std::min(bvRingDim, hybridRingDim);
+    }
+    return params;
+}
+
+PlanValidation ParameterPlanner::Validate(const PipelineParams& params) const {
+    PlanValidation validation;
+    SchemeSwitchPipeline pipeline(params);
+    validation.setupMs = TimeMs([&] {
+        pipeline.Setup();
+        pipeline.GenerateEvalKeys();
+    });
+    const CryptoContext<DCRTPoly>& cc = pipeline.GetCryptoContext();
+    validation.ringDim                = cc->GetRingDimension();
+
+    // an aggregate precision above and one at precision - 1 below every threshold
+    const int64_t gap   = static_cast<int64_t>(std::ceil(workload.precision));
+    const int64_t upper = static_cast<int64_t>(params.upperBound);
+    std::vector<double> evalMs, decryptMs;
+    validation.correct = true;
+    validation.margin  = INFINITY;
+    for (int64_t threshold : {int64_t(0), upper / 2, std::max<int64_t>(0, upper - gap)}) {
+        const double above = std::min(threshold + gap, upper);
+        const double below = std::max<int64_t>(threshold - gap + 1, 0);
+        auto ciphertext =
+            cc->Encrypt(pipeline.GetJointPublicKey(), cc->MakeCKKSPackedPlaintext(std::vector<double>{above, below}));
+
+        Ciphertext<DCRTPoly> result;
+        evalMs.push_back(TimeMs([&] { result = pipeline.EvaluateThreshold(ciphertext, threshold); }));
+        Plaintext plaintext;
+        decryptMs.push_back(TimeMs([&] { plaintext = pipeline.Decrypt(result); }));
+
+        auto values = plaintext->GetRealPackedValue();
+        if (above > threshold) {
+            validation.correct = validation.correct && values[0] > 0;
+            validation.margin  = std::min(validation.margin, values[0]);
+        }
+        validation.correct = validation.correct && values[1] < 0;
+        validation.margin  = std::min(validation.margin, -values[1]);
+    }
+    validation.evalMs    = *std::max_element(evalMs.begin(), evalMs.end());
+    validation.decryptMs = *std::max_element(decryptMs.begin(), decryptMs.end());
+    return validation;
+}
+
+PipelineParams ParameterPlanner::PlanAndValidate(usint maxAttempts) const {
+    PipelineParams params = Plan();
+    for (usint attempt = 0; attempt < maxAttempts; ++attempt) {
+        if (Validate(params).correct) {
+            return params;
+        }
+        if (params.scalingModSize + 5 <= MAX_SCALING_BITS) {
+            params.scalingModSize += 5;
+        }
+        else {
+            params.signIterations += 1;
+            params.multDepth = ComparisonEngine::SignDepth(params.signIterations);
+        }
+    }
+    OPENFHE_THROW(config_error, "No parameters passed validation after " + std::to_string(maxAttempts) + " attempts");
+}
+
+uint32_t ParameterPlanner::EstimateModulusBits(usint multDepth, usint scalingModSize, KeySwitchTechnique technique) {
+    const uint32_t logQ = FIRST_MOD_BITS + multDepth * scalingModSize;
+    if (technique == BV) {
+        return logQ;
+    }
+    // OpenFHE's default number of HYBRID digits; P covers one digit in 60-bit primes
+    const uint32_t digits      = (multDepth > 3) ? 3 : (multDepth >= 1 ? 2 : 1);
+    const uint32_t digitBits   = (logQ + digits - 1) / digits;
+    const uint32_t auxiliaryQP = ((digitBits + FIRST_MOD_BITS - 1) / FIRST_MOD_BITS) * FIRST_MOD_BITS;
+    return logQ + auxiliaryQP;
+}
+
+usint ParameterPlanner::MinRingDimension(uint32_t logQP, SecurityLevel securityLevel, usint minRingDim) {
+    const uint32_t* bounds = (securityLevel == HEStd_192_classic)   ? MAX_LOGQ_192
+                             : (securityLevel == HEStd_256_classic) ? MAX_LOGQ_256
+                                                                    : MAX_LOGQ_128;
+    usint ringDim = 1024;
+    for (size_t i = 0; i < sizeof(MAX_LOGQ_128) / sizeof(MAX_LOGQ_128[0]); ++i, ringDim *= 2) {
+        if (ringDim >= minRingDim && (securityLevel == HEStd_NotSet || logQP <= bounds[i])) {
+            return ringDim;
+        }
+    }
+    OPENFHE_THROW(config_error, "A modulus of " + std::to_string(logQP) + " bits needs a ring dimension above " +
+                                    std::to_string(ringDim / 2));
+}
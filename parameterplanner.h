@@ -0,0 +1,90 @@
+#ifndef OPENFHE_PARAMETERPLANNER_H
+#define OPENFHE_PARAMETERPLANNER_H
+
+#include "openfhe.h"
+
+#include "pipeline.h"
+
+using namespace lbcrypto;
+
+/**
+ * What the SA to FHE conversion has to handle: the planner derives the CKKS
+ * parameters from it instead of hard-coding them per program.
+ */
+struct Workload {
+    usint numParties = 5;
+    // largest value a party contributes; aggregates lie in [0, numParties * maxValue]
+    int64_t maxValue = 8;
+    // smallest distance between an aggregate and the threshold whose decision
+    // has to be right; aggregates are integers, so at least 1
+    double precision = 1;
+    SecurityLevel securityLevel = HEStd_128_classic;
+    usint batchSize             = 16;
+};
+
+/**
+ * Outcome of the micro-benchmark behind ParameterPlanner::Validate.
+ */
+struct PlanValidation {
+    bool correct = false;
+    // smallest |result| on the right side of zero
+    double margin = 0;
+    usint ringDim = 0;
+    double setupMs   = 0;
+    double evalMs    = 0;
+    double decryptMs = 0;
+};
+
+/**
+ * Picks the threshold check kernel, multiplicative depth, scaling modulus size,
+ * ring dimension, key switching technique and threshold party count for a
+ * workload:
+ *
+ *  - the sign kernel (see ComparisonEngine::EvalGreater) with the fewest
+ *    iterations whose decision margin at the required precision stays well
+ *    above the CKKS error, which determines the depth;
+ *  - the smallest scaling modulus that resolves that margin;
+ *  - the smallest ring dimension whose security bound covers the estimated
+ *    log2(QP), and BV key switching when it saves a ring dimension over
+ *    HYBRID (BV needs no extra P moduli, but its cost grows with the square
+ *    of the tower count, so it only pays off for the shallow circuits here);
+ *  - the actual party count as OpenFHE's threshold party count.
+ *
+ * Validate() runs the planned parameters on test aggregates around several
+ * thresholds; PlanAndValidate() widens the scaling modulus until they pass.
+ */
+class ParameterPlanner {
+public:
+    explicit ParameterPlanner(const Workload& workload);
+
+    PipelineParams Plan() const;
+
+    /**
+     * Sets up a pipeline with params and threshold-checks aggregates at
+     * distance precision on both sides of thresholds across the range.
+     * params.comparison must be a deciding kernel ("sign" or "fhew").
+     */
+    PlanValidation Validate(const PipelineParams& params) const;
+
+    /**
+     * Plan() followed by Validate(), raising the scaling modulus size after a
+     * failed validation up to maxAttempts times.
+     */
+    PipelineParams PlanAndValidate(usint maxAttempts = 3) const;
+
+    /**
+     * Estimated log2 of the full modulus QP of a CKKS context with these parameters.
+     */
+    static uint32_t EstimateModulusBits(usint multDepth, usint scalingModSize, KeySwitchTechnique technique);
+
+    /**
+     * Smallest power-of-two ring dimension of at least minRingDim whose
+     * HE standard bound admits logQP bits at securityLevel.
+     */
+    static usint MinRingDimension(uint32_t logQP, SecurityLevel securityLevel, usint minRingDim);
+
+private:
+    Workload workload;
+};
+
+#endif  //OPENFHE_PARAMETERPLANNER_H
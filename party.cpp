@@ -0,0 +1,87 @@
+#include "party.h"
+#include "tracer.h"
+
+namespace {
+
+/**
+ * Shamir shares f(1), ..., f(numParties) of secret for a random polynomial f of
+ * degree threshold - 1 with f(0) = secret, in COEFFICIENT format like the
+ * shares of CryptoContextImpl::ShareKeys. Unlike ShareKeys, the dealer's own
+ * index is included: as a summand of the joint key share it is dealt to itself.
+ */
+std::unordered_map<uint32_t, DCRTPoly> ShamirShares(const DCRTPoly& secret, usint numParties, usint threshold) {
+    DCRTPoly constant = secret;
+    constant.SetFormat(Format::COEFFICIENT);
+    const auto& elementParams = constant.GetParams();
+
+    // f(x) = secret + a_1 x + ... + a_{t-1} x^{t-1}
+    DCRTPoly::DugType dug;
+    std::vector<DCRTPoly> coefficients;
+    coefficients.reserve(threshold - 1);
+    for (usint k = 1; k < threshold; ++k) {
+        coefficients.emplace_back(dug, elementParams, Format::COEFFICIENT);
+    }
+
+    const auto& towers = elementParams->GetParams();
+    std::unordered_map<uint32_t, DCRTPoly> shares;
+    for (uint32_t x = 1; x <= numParties; ++x) {
+        std::vector<NativeInteger> xs(towers.size());
+        for (size_t k = 0; k < towers.size(); ++k) {
+            xs[k] = NativeInteger(x).Mod(towers[k]->GetModulus());
+        }
+        // Horner's rule from the highest coefficient down
+        DCRTPoly share = constant;
+        if (!coefficients.empty()) {
+            share = coefficients.back();
+            for (size_t k = coefficients.size() - 1; k-- > 0;) {
+                share = share.Times(xs);
+                share += coefficients[k];
+            }
+            share = share.Times(xs);
+            share += constant;
+        }
+        shares.emplace(x, std::move(share));
+    }
+    return shares;
+}
+
+}  // namespace
+
+Party::Party(usint id, const CryptoContext<DCRTPoly>& cc) : id(id), cc(cc) {}
+
+void Party::GenerateKeys(const PublicKey<DCRTPoly>& prevPublicKey, bool fresh) {
+    TraceScope scope("party_keygen", id);
+    if (prevPublicKey == nullptr) {
+        keyPair = cc->KeyGen();
+    }
+    else {
+        keyPair = cc->MultipartyKeyGen(prevPublicKey, false, fresh);
+    }
+    if (!keyPair.good()) {
+        OPENFHE_THROW(openfhe_error, "Key generation failed for party " + std::to_string(id));
+    }
+}
+
+Plaintext Party::Encode(const SAEncoder& encoder) const {
+    TraceScope scope("encode", id);
+    return encoder.Encode(values);
+}
+
+Ciphertext<DCRTPoly> Party::Encrypt(const PublicKey<DCRTPoly>& jointPublicKey, const SAEncoder& encoder) const {
+    Plaintext plaintext = Encode(encoder);
+    TraceScope scope("encrypt", id);
+    return cc->Encrypt(jointPublicKey, plaintext);
+}
+
+void Party::ShareKey(usint numParties, usint threshold, const std::string& shareType) {
+    TraceScope scope("share_key", id);
+    if (threshold == 0 || threshold > numParties) {
+        OPENFHE_THROW(config_error, "The sharing threshold must be between 1 and the number of parties");
+    }
+    if (shareType == "shamir") {
+        keyShares = ShamirShares(keyPair.secretKey->GetPrivateElement(), numParties, threshold);
+    }
+    else {
+        keyShares = cc->ShareKeys(keyPair.secretKey, numParties, threshold, id, shareType);
+    }
+}
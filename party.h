@@ -0,0 +1,133 @@
+#ifndef OPENFHE_PARTY_H
+#define OPENFHE_PARTY_H
+
+#include "openfhe.h"
+
+#include "encoder.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace lbcrypto;
+
+/**
+ * One participant of the SA to FHE conversion. A party owns its share of the
+ * joint threshold key, its (secret) aggregation values and, when fault tolerance
+ * is enabled, the Shamir shares of its secret key that the other parties hold.
+ * For t-of-N decryption it also holds its Shamir share of the joint secret key.
+ */
+class Party {
+public:
+    /**
+     * @param id - 1-based party index; also used as the party's Shamir share index
+     * @param cc - crypto context shared by all parties
+     */
+    Party(usint id, const CryptoContext<DCRTPoly>& cc);
+
+    usint GetId() const {
+        return id;
+    }
+
+    /**
+     * Runs this party's round of the joint public key generation.
+     * @param prevPublicKey - joint public key of the parties before this one, or
+     *                        nullptr for the first party
+     * @param fresh - if true, the returned public key only covers this party's
+     *                secret (same "a" as prevPublicKey) and has to be combined with
+     *                the others' via MultiAddPubKeys
+     */
+    void GenerateKeys(const PublicKey<DCRTPoly>& prevPublicKey, bool fresh = false);
+
+    const KeyPair<DCRTPoly>& GetKeyPair() const {
+        return keyPair;
+    }
+
+    // restores previously generated key material (see KeyStore)
+    void SetKeyPair(const KeyPair<DCRTPoly>& keys) {
+        keyPair = keys;
+    }
+
+    const PrivateKey<DCRTPoly>& GetSecretKey() const {
+        return keyPair.secretKey;
+    }
+
+    const PublicKey<DCRTPoly>& GetPublicKey() const {
+        return keyPair.publicKey;
+    }
+
+    void SetValue(int64_t val) {
+        values = {val};
+    }
+
+    int64_t GetValue() const {
+        return values.at(0);
+    }
+
+    /**
+     * Several metrics per party; they are encoded into consecutive slots.
+     */
+    void SetValues(const std::vector<int64_t>& vals) {
+        values = vals;
+    }
+
+    const std::vector<int64_t>& GetValues() const {
+        return values;
+    }
+
+    /**
+     * Encodes the party's SA values into the leading slots of a packed
+     * plaintext (see SAEncoder).
+     */
+    Plaintext Encode(const SAEncoder& encoder) const;
+
+    /**
+     * Encodes and encrypts the party's values under the joint public key.
+     */
+    Ciphertext<DCRTPoly> Encrypt(const PublicKey<DCRTPoly>& jointPublicKey, const SAEncoder& encoder) const;
+
+    /**
+     * Splits the secret key into shares, any threshold of which can rebuild it
+     * with CryptoContextImpl::RecoverSharedKey: "additive" shares for the other
+     * parties (from CryptoContextImpl::ShareKeys), or "shamir" shares for all
+     * numParties indices including this party's own, which the joint key share
+     * needs (see SchemeSwitchPipeline::CombineJointKeyShares).
+     */
+    void ShareKey(usint numParties, usint threshold, const std::string& shareType);
+
+    const std::unordered_map<uint32_t, DCRTPoly>& GetKeyShares() const {
+        return keyShares;
+    }
+
+    void SetKeyShares(const std::unordered_map<uint32_t, DCRTPoly>& shares) {
+        keyShares = shares;
+    }
+
+    /**
+     * Shamir share of the joint secret key at this party's index: the sum of
+     * the shares all parties dealt to it with ShareKey.
+     */
+    void SetJointKeyShare(const DCRTPoly& share) {
+        jointKeyShare    = share;
+        hasJointKeyShare = true;
+    }
+
+    const DCRTPoly& GetJointKeyShare() const {
+        return jointKeyShare;
+    }
+
+    bool HasJointKeyShare() const {
+        return hasJointKeyShare;
+    }
+
+private:
+    usint id;
+    CryptoContext<DCRTPoly> cc;
+    KeyPair<DCRTPoly> keyPair;
+    std::vector<int64_t> values = {0};
+    std::unordered_map<uint32_t, DCRTPoly> keyShares;
+    DCRTPoly jointKeyShare;
+    bool hasJointKeyShare = false;
+};
+
+#endif  //OPENFHE_PARTY_H
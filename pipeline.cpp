@@ -0,0 +1,515 @@
+#include "pipeline.h"
+#include "ciphertextcontainer.h"
+#include "compactciphertext.h"
+#include "keystore.h"
+#include "memoryreport.h"
+#include "streamingaggregator.h"
+#include "tracer.h"
+
+// header files needed for serialization
+#include "ciphertext-ser.h"
+#include "cryptocontext-ser.h"
+#include "key/key-ser.h"
+#include "scheme/bfvrns/bfvrns-ser.h"
+#include "scheme/bgvrns/bgvrns-ser.h"
+#include "scheme/ckksrns/ckksrns-ser.h"
+
+#include <cmath>
+
+namespace {
+
+// batching needs t = 1 mod 2n; this covers every ring dimension n up to 2^15
+const uint64_t BATCHING_MODULUS = uint64_t(1) << 16;
+
+bool IsPrime(uint64_t n) {
+    if (n < 2) {
+        return false;
+    }
+    for (uint64_t d = 2; d * d <= n; ++d) {
+        if (n % d == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Smallest batching-friendly prime that holds every aggregate in [0, bound]:
+// packed BGV/BFV slots decode to [-t/2, t/2), so t has to exceed 2 * bound.
+uint64_t IntegerPlaintextModulus(uint64_t bound) {
+    uint64_t t = BATCHING_MODULUS + 1;
+    while (t <= 2 * bound || !IsPrime(t)) {
+        t += BATCHING_MODULUS;
+    }
+    return t;
+}
+
+template <typename Scheme>
+CCParams<Scheme> IntegerParameters(const PipelineParams& params) {
+    const uint64_t bound = (params.maxValue > 0) ? uint64_t(params.maxValue) * params.numParties
+                                                 : static_cast<uint64_t>(params.upperBound);
+    CCParams<Scheme> parameters;
+    parameters.SetSecurityLevel(params.securityLevel);
+    parameters.SetMultiplicativeDepth(params.multDepth);
+    parameters.SetPlaintextModulus(IntegerPlaintextModulus(bound));
+    parameters.SetBatchSize(params.batchSize);
+    parameters.SetRingDim(params.ringDim);
+    parameters.SetKeySwitchTechnique(params.keySwitchTechnique);
+    parameters.SetThresholdNumOfParties(params.thresholdParties);
+    return parameters;
+}
+
+}  // namespace
+
+SchemeSwitchPipeline::SchemeSwitchPipeline(const PipelineParams& params)
+    : params(params), pool(std::make_unique<ThreadPool>(params.numThreads)) {
+    if (params.numParties < 2) {
+        OPENFHE_THROW(config_error, "The SA to FHE conversion needs at least 2 parties");
+    }
+    if (params.metricsPerParty == 0 || params.metricsPerParty > params.batchSize) {
+        OPENFHE_THROW(config_error, "Every party needs between 1 and batchSize metrics");
+    }
+    if (params.thresholdDecryption && params.shareType != "shamir") {
+        OPENFHE_THROW(config_error, "t-of-N decryption needs Shamir sharing");
+    }
+    if (params.scheme != "ckks" && params.scheme != "bgv" && params.scheme != "bfv") {
+        OPENFHE_THROW(config_error, "Unknown scheme " + params.scheme);
+    }
+    if (params.scheme != "ckks" && (params.compactWire || params.comparison == "fhew")) {
+        OPENFHE_THROW(config_error, "The compact wire format and the FHEW comparison need CKKS");
+    }
+    if (params.comparison != "max" && params.comparison != "sign" && params.comparison != "fhew") {
+        OPENFHE_THROW(config_error, "Unknown comparison kernel " + params.comparison);
+    }
+    if (params.comparison == "fhew" && !params.dealerSchemeSwitching) {
+        OPENFHE_THROW(config_error, "The FHEW comparison needs a trusted dealer; set dealerSchemeSwitching");
+    }
+    if (params.comparison == "sign" && params.signIterations == 0) {
+        OPENFHE_THROW(config_error, "The sign comparison needs at least one iteration");
+    }
+    if (this->params.thresholdParties == 0) {
+        this->params.thresholdParties = params.numParties;
+    }
+    if (params.scheme == "ckks" && params.comparison == "max" && params.polyDegree == 0) {
+        this->params.polyDegree = ComparisonEngine::ReluDegree(params.upperBound - params.lowerBound);
+    }
+    if (this->params.multDepth == 0) {
+        // the integer schemes only add; the threshold check is CKKS only
+        this->params.multDepth = (params.scheme == "ckks") ? GetComparisonDepth() : 1;
+    }
+}
+
+void SchemeSwitchPipeline::SetCiphertextSink(std::unique_ptr<CiphertextSink> ciphertextSink) {
+    sink = std::move(ciphertextSink);
+}
+
+bool SchemeSwitchPipeline::Setup() {
+    bool loaded = false;
+    if (!params.keyStoreDir.empty()) {
+        TraceScope scope("key_store_load");
+        MemoryPhase memoryPhase("key_store_load");
+        loaded = KeyStore(params.keyStoreDir).Load(params, cc, jointPublicKey, parties, evalKeys);
+    }
+    if (loaded) {
+        MemoryReport::Global().RecordKeyMaterial(cc, jointPublicKey, parties);
+        InitComparison();
+        InitSchemeSwitching();
+        return true;
+    }
+
+    GenerateContext();
+    GenerateKeys();
+
+    if (!params.keyStoreDir.empty()) {
+        // the store is meant to skip the whole ceremony on the next start
+        GenerateEvalKeys();
+        TraceScope scope("key_store_save");
+        MemoryPhase memoryPhase("key_store_save");
+        KeyStore(params.keyStoreDir).Save(params, cc, jointPublicKey, parties, GetGeneratedEvalKeys());
+    }
+    // after saving: the FHEW keys are not part of the store and are regenerated on every start
+    InitSchemeSwitching();
+    return false;
+}
+
+void SchemeSwitchPipeline::GenerateContext() {
+    TraceScope scope("context");
+    MemoryPhase memoryPhase("context");
+    if (params.scheme == "bgv") {
+        cc = GenCryptoContext(IntegerParameters<CryptoContextBGVRNS>(params));
+    }
+    else if (params.scheme == "bfv") {
+        cc = GenCryptoContext(IntegerParameters<CryptoContextBFVRNS>(params));
+    }
+    else {
+        CCParams<CryptoContextCKKSRNS> parameters;
+        parameters.SetSecurityLevel(params.securityLevel);
+        parameters.SetMultiplicativeDepth(params.multDepth);
+        parameters.SetScalingModSize(params.scalingModSize);
+        parameters.SetBatchSize(params.batchSize);
+        parameters.SetRingDim(params.ringDim);
+        parameters.SetKeySwitchTechnique(params.keySwitchTechnique);
+        parameters.SetThresholdNumOfParties(params.thresholdParties);
+        if (params.comparison == "fhew") {
+            parameters.SetScalingTechnique(FLEXIBLEAUTO);
+            parameters.SetFirstModSize(60);
+        }
+        cc = GenCryptoContext(parameters);
+    }
+    if (params.scheme != "ckks" && 2 * cc->GetRingDimension() > BATCHING_MODULUS) {
+        OPENFHE_THROW(config_error, "Ring dimension " + std::to_string(cc->GetRingDimension()) +
+                                        " is too large for the batching plaintext modulus");
+    }
+
+    cc->Enable(PKE);
+    cc->Enable(KEYSWITCH);
+    cc->Enable(LEVELEDSHE);
+    cc->Enable(ADVANCEDSHE);
+    cc->Enable(MULTIPARTY);
+    if (params.comparison == "fhew") {
+        cc->Enable(SCHEMESWITCH);
+    }
+
+    parties.clear();
+    parties.reserve(params.numParties);
+    for (usint i = 0; i < params.numParties; ++i) {
+        parties.emplace_back(i + 1, cc);
+    }
+
+    InitComparison();
+}
+
+void SchemeSwitchPipeline::InitComparison() {
+    if (params.scheme != "ckks") {
+        comparison.reset();
+        return;
+    }
+    // computes the ReLU coefficients now, off the query path; "fhew" uses neither kernel
+    const uint32_t degree         = (params.comparison == "max") ? params.polyDegree : 0;
+    const uint32_t signIterations = (params.comparison == "sign") ? params.signIterations : 0;
+    comparison = std::make_unique<ComparisonEngine>(cc, params.lowerBound, params.upperBound, degree,
+                                                    params.multDepth, signIterations);
+}
+
+void SchemeSwitchPipeline::InitSchemeSwitching() {
+    if (params.comparison != "fhew") {
+        return;
+    }
+    TraceScope scope("fhew_setup");
+    MemoryPhase memoryPhase("fhew_setup");
+    // dealer step (params.dealerSchemeSwitching): the switching keys need the
+    // joint secret, which no party holds
+    DCRTPoly jointSecret = parties[0].GetSecretKey()->GetPrivateElement();
+    for (size_t i = 1; i < parties.size(); ++i) {
+        jointSecret += parties[i].GetSecretKey()->GetPrivateElement();
+    }
+    KeyPair<DCRTPoly> jointKeys;
+    jointKeys.publicKey = jointPublicKey;
+    jointKeys.secretKey = std::make_shared<PrivateKeyImpl<DCRTPoly>>(cc);
+    jointKeys.secretKey->SetPrivateElement(jointSecret);
+    jointKeys.secretKey->SetKeyTag(jointPublicKey->GetKeyTag());
+
+    fhewComparator = std::make_unique<FhewComparator>(cc, jointKeys, params.lowerBound, params.upperBound,
+                                                      params.metricsPerParty, params.batchSize, params.securityLevel);
+}
+
+void SchemeSwitchPipeline::GenerateKeys() {
+    {
+        TraceScope scope("key_ceremony");
+        MemoryPhase memoryPhase("key_ceremony");
+        jointPublicKey = KeyCeremony(cc, *pool).Run(parties, EvalKeyPlan());
+        {
+            std::lock_guard<std::mutex> lock(evalKeyMtx);
+            evalKeys = EvalKeyPlan();
+        }
+
+        if (params.faultTolerant || params.thresholdDecryption) {
+            ShareKeys();
+        }
+        if (params.thresholdDecryption) {
+            CombineJointKeyShares();
+        }
+    }
+    // outside the phase: serializing the keys to size them would raise its peak
+    MemoryReport::Global().RecordKeyMaterial(cc, jointPublicKey, parties);
+}
+
+EvalKeyPlan SchemeSwitchPipeline::GetEvalKeyPlan() const {
+    EvalKeyPlan plan;
+    // the "fhew" kernel's way back to CKKS evaluates a polynomial as well
+    plan.mult = (params.scheme == "ckks");
+    return plan;
+}
+
+void SchemeSwitchPipeline::GenerateEvalKeys() {
+    EnsureEvalKeys(GetEvalKeyPlan());
+}
+
+EvalKeyPlan SchemeSwitchPipeline::GetGeneratedEvalKeys() const {
+    std::lock_guard<std::mutex> lock(evalKeyMtx);
+    return evalKeys;
+}
+
+void SchemeSwitchPipeline::EnsureEvalKeys(const EvalKeyPlan& needed) const {
+    std::lock_guard<std::mutex> lock(evalKeyMtx);
+    const EvalKeyPlan missing = evalKeys.Missing(needed);
+    if (missing.IsEmpty()) {
+        return;
+    }
+    if (jointPublicKey == nullptr) {
+        OPENFHE_THROW(openfhe_error, "No joint key; call Setup() or GenerateKeys() first");
+    }
+    TraceScope scope("eval_keys");
+    KeyCeremony(cc, *pool).GenerateEvalKeys(parties, jointPublicKey->GetKeyTag(), missing);
+    evalKeys.Merge(missing);
+}
+
+void SchemeSwitchPipeline::ShareKeys() {
+    pool->ParallelFor(0, parties.size(), [&](size_t i) {
+        parties[i].ShareKey(params.numParties, GetThreshold(), params.shareType);
+    });
+}
+
+void SchemeSwitchPipeline::CombineJointKeyShares() {
+    // Party j's share of the joint key is the sum of the shares dealt to it;
+    // in a deployment every dealer sends share j to party j only.
+    pool->ParallelFor(0, parties.size(), [&](size_t j) {
+        TraceScope scope("joint_key_share", parties[j].GetId());
+        const uint32_t index = parties[j].GetId();
+        DCRTPoly jointShare  = parties[0].GetKeyShares().at(index);
+        for (size_t i = 1; i < parties.size(); ++i) {
+            jointShare += parties[i].GetKeyShares().at(index);
+        }
+        parties[j].SetJointKeyShare(jointShare);
+    });
+}
+
+void SchemeSwitchPipeline::SetValues(const std::vector<int64_t>& values) {
+    if (values.size() != parties.size()) {
+        OPENFHE_THROW(config_error, "Expected one value per party");
+    }
+    for (size_t i = 0; i < values.size(); ++i) {
+        parties[i].SetValue(values[i]);
+    }
+}
+
+void SchemeSwitchPipeline::SetMetrics(const std::vector<std::vector<int64_t>>& metrics) {
+    if (metrics.size() != parties.size()) {
+        OPENFHE_THROW(config_error, "Expected one metric vector per party");
+    }
+    for (size_t i = 0; i < metrics.size(); ++i) {
+        if (metrics[i].size() != params.metricsPerParty) {
+            OPENFHE_THROW(config_error, "Expected " + std::to_string(params.metricsPerParty) + " metrics per party");
+        }
+        parties[i].SetValues(metrics[i]);
+    }
+}
+
+std::vector<Ciphertext<DCRTPoly>> SchemeSwitchPipeline::EncryptAll() {
+    TraceScope scope("encrypt_all");
+    MemoryPhase memoryPhase("encrypt_all");
+    if (!sink && !params.containerPath.empty()) {
+        sink = std::make_unique<ContainerSink>(cc, params.containerPath,
+                                               ContainerWriter::ContextId(cc, jointPublicKey->GetKeyTag()),
+                                               params.compactWire, params.numWriters, params.syncWrites);
+    }
+    else if (!sink && !params.dataFolder.empty()) {
+        sink = std::make_unique<FileSink>(cc, params.dataFolder, params.compactWire, params.numWriters,
+                                          params.syncWrites);
+    }
+
+    std::vector<Ciphertext<DCRTPoly>> ciphertexts(parties.size());
+    SAEncoder encoder(cc, params.batchSize);
+    const uint32_t levelsToDrop =
+        params.compactWire ? CompactCodec::LevelsToDrop(params.multDepth, GetComparisonDepth()) : 0;
+
+    pool->ParallelFor(0, parties.size(), [&](size_t i) {
+        ciphertexts[i] = parties[i].Encrypt(jointPublicKey, encoder);
+        if (levelsToDrop > 0) {
+            TraceScope dropScope("level_reduce", parties[i].GetId());
+            cc->LevelReduceInPlace(ciphertexts[i], nullptr, levelsToDrop);
+        }
+        if (sink) {
+            sink->Write(i, ciphertexts[i]);
+        }
+    });
+
+    if (sink) {
+        TraceScope flushScope("sink_flush");
+        sink->Flush();
+    }
+    MemoryReport::Global().RecordCiphertext("party ciphertext", ciphertexts[0], ciphertexts.size());
+    return ciphertexts;
+}
+
+Ciphertext<DCRTPoly> SchemeSwitchPipeline::Aggregate(const std::vector<Ciphertext<DCRTPoly>>& ciphertexts,
+                                                     const std::set<usint>& faulted) const {
+    TraceScope scope("aggregate");
+    MemoryPhase memoryPhase("aggregate");
+    std::vector<Ciphertext<DCRTPoly>> received;
+    received.reserve(ciphertexts.size());
+    for (usint i = 0; i < ciphertexts.size(); ++i) {
+        if (faulted.count(i) == 0) {
+            received.push_back(ciphertexts[i]);
+        }
+    }
+    auto aggregate = Aggregator(cc, pool.get()).Aggregate(received);
+    MemoryReport::Global().RecordCiphertext("aggregate", aggregate, 1);
+    return aggregate;
+}
+
+Ciphertext<DCRTPoly> SchemeSwitchPipeline::AggregateFromFolder(const std::string& folder, size_t expected,
+                                                               std::chrono::milliseconds timeout) const {
+    TraceScope scope("aggregate");
+    MemoryPhase memoryPhase("aggregate");
+    StreamingAggregator streamingAggregator(cc, *pool);
+    size_t received = streamingAggregator.ConsumeDirectory(folder, expected, timeout);
+    if (received < expected) {
+        std::cerr << " Only " << received << " of " << expected << " ciphertexts arrived in " << folder << std::endl;
+    }
+    return streamingAggregator.Finalize();
+}
+
+Ciphertext<DCRTPoly> SchemeSwitchPipeline::AggregateFromContainer(const std::string& path) const {
+    TraceScope scope("aggregate");
+    MemoryPhase memoryPhase("aggregate");
+    ContainerReader container(path);
+    if (container.GetContextId() != ContainerWriter::ContextId(cc, jointPublicKey->GetKeyTag())) {
+        OPENFHE_THROW(openfhe_error, "Container " + path + " was written for another key set");
+    }
+    StreamingAggregator streamingAggregator(cc, *pool);
+    streamingAggregator.ConsumeContainer(container);
+    return streamingAggregator.Finalize();
+}
+
+Ciphertext<DCRTPoly> SchemeSwitchPipeline::EvaluateThreshold(const Ciphertext<DCRTPoly>& aggregate,
+                                                             double threshold) const {
+    TraceScope scope("threshold_check");
+    MemoryPhase memoryPhase("threshold_check");
+    if (params.scheme != "ckks") {
+        OPENFHE_THROW(config_error, "The threshold check needs CKKS; BGV/BFV aggregates are exact after decryption");
+    }
+    EvalKeyPlan multOnly;
+    multOnly.mult = true;
+    EnsureEvalKeys(multOnly);
+    if (params.comparison == "fhew") {
+        if (fhewComparator == nullptr) {
+            OPENFHE_THROW(openfhe_error, "No scheme switching keys; call Setup() first");
+        }
+        auto result = fhewComparator->EvalGreater(aggregate, threshold);
+        MemoryReport::Global().RecordCiphertext("threshold result", result, 1);
+        return result;
+    }
+    if (comparison == nullptr) {
+        OPENFHE_THROW(openfhe_error, "No crypto context; call Setup() or GenerateContext() first");
+    }
+    auto result = (params.comparison == "sign") ? comparison->EvalGreater(aggregate, threshold)
+                                                : comparison->EvalMax(aggregate, std::floor(threshold));
+    MemoryReport::Global().RecordCiphertext("threshold result", result, 1);
+    return result;
+}
+
+bool SchemeSwitchPipeline::IsAboveThreshold(double value, double threshold) const {
+    if (params.comparison == "max") {
+        // max(floor(threshold), x) decodes to at most floor(threshold) + error for an integer
+        // x <= threshold and to at least floor(threshold) + 1 - error otherwise, where the ReLU
+        // error is at most ComparisonEngine::MAX_RELU_ERROR < 0.5; the cutoff is halfway
+        return value > std::floor(threshold) + 0.5;
+    }
+    // positive above the threshold, negative at or below it
+    return value > 0;
+}
+
+Plaintext SchemeSwitchPipeline::Decrypt(const Ciphertext<DCRTPoly>& ciphertext, const std::set<usint>& faulted) const {
+    return DecryptBatch({ciphertext}, faulted)[0];
+}
+
+std::vector<Plaintext> SchemeSwitchPipeline::DecryptBatch(const std::vector<Ciphertext<DCRTPoly>>& ciphertexts,
+                                                          const std::set<usint>& faulted) const {
+    TraceScope scope("decrypt");
+    MemoryPhase memoryPhase("decrypt");
+    Decryptor decryptor(cc, *pool);
+    std::vector<uint32_t> partyIds;
+    auto secretKeys = params.thresholdDecryption ? ThresholdDecryptionKeys(decryptor, faulted, partyIds)
+                                                 : DecryptionKeys(faulted, partyIds);
+    return decryptor.DecryptBatch(ciphertexts, secretKeys, partyIds);
+}
+
+std::map<usint, PrivateKey<DCRTPoly>> SchemeSwitchPipeline::RecoverKeys(const std::set<usint>& faulted,
+                                                                        const std::set<usint>& unavailable) const {
+    std::set<usint> missing = unavailable;
+    missing.insert(faulted.begin(), faulted.end());
+
+    const usint tolerated = GetMaxRecoverable();
+    if (missing.size() > tolerated) {
+        OPENFHE_THROW(openfhe_error, std::to_string(missing.size()) + " parties are missing, at most " +
+                                         std::to_string(tolerated) + " can be recovered with " + params.shareType +
+                                         " sharing");
+    }
+
+    Decryptor decryptor(cc, *pool);
+    const std::vector<usint> lost(faulted.begin(), faulted.end());
+    std::vector<PrivateKey<DCRTPoly>> recovered(lost.size());
+    pool->ParallelFor(0, lost.size(), [&](size_t k) {
+        const Party& party = parties.at(lost[k]);
+        TraceScope scope("recover_key", party.GetId());
+        if (party.GetKeyShares().empty()) {
+            OPENFHE_THROW(openfhe_error, "No key shares to recover faulted party " + std::to_string(party.GetId()));
+        }
+        // only the shares held by parties that are still present can be collected
+        std::unordered_map<uint32_t, DCRTPoly> available;
+        for (const auto& [index, share] : party.GetKeyShares()) {
+            if (missing.count(index - 1) == 0) {
+                available.emplace(index, share);
+            }
+        }
+        recovered[k] = decryptor.RecoverKey(available, params.numParties, GetThreshold(), params.shareType);
+    });
+
+    std::map<usint, PrivateKey<DCRTPoly>> keys;
+    for (size_t k = 0; k < lost.size(); ++k) {
+        keys.emplace(lost[k], recovered[k]);
+    }
+    return keys;
+}
+
+std::vector<PrivateKey<DCRTPoly>> SchemeSwitchPipeline::DecryptionKeys(const std::set<usint>& faulted,
+                                                                       std::vector<uint32_t>& partyIds) const {
+    auto recovered = RecoverKeys(faulted);
+
+    std::vector<PrivateKey<DCRTPoly>> secretKeys;
+    secretKeys.reserve(parties.size());
+    partyIds.clear();
+    for (usint i = 0; i < parties.size(); ++i) {
+        secretKeys.push_back((faulted.count(i) == 0) ? parties[i].GetSecretKey() : recovered.at(i));
+        partyIds.push_back(parties[i].GetId());
+    }
+    return secretKeys;
+}
+
+std::vector<PrivateKey<DCRTPoly>> SchemeSwitchPipeline::ThresholdDecryptionKeys(const Decryptor& decryptor,
+                                                                                const std::set<usint>& faulted,
+                                                                                std::vector<uint32_t>& indices) const {
+    std::vector<usint> participants;
+    indices.clear();
+    for (usint i = 0; i < parties.size() && participants.size() < GetThreshold(); ++i) {
+        if (faulted.count(i) == 0) {
+            participants.push_back(i);
+            indices.push_back(parties[i].GetId());
+        }
+    }
+    if (participants.size() < GetThreshold()) {
+        OPENFHE_THROW(openfhe_error, "Only " + std::to_string(participants.size()) + " parties left, " +
+                                         std::to_string(GetThreshold()) + " are needed to decrypt");
+    }
+
+    std::vector<PrivateKey<DCRTPoly>> secretKeys(participants.size());
+    pool->ParallelFor(0, participants.size(), [&](size_t k) {
+        const Party& party = parties[participants[k]];
+        TraceScope scope("lagrange_key", party.GetId());
+        if (!party.HasJointKeyShare()) {
+            OPENFHE_THROW(openfhe_error, "Party " + std::to_string(party.GetId()) + " holds no joint key share");
+        }
+        secretKeys[k] = decryptor.LagrangeWeightedKey(party.GetId(), party.GetJointKeyShare(), indices);
+    });
+    return secretKeys;
+}
@@ -0,0 +1,313 @@
+#ifndef OPENFHE_PIPELINE_H
+#define OPENFHE_PIPELINE_H
+
+#include "openfhe.h"
+
+#include "aggregator.h"
+#include "ciphertextsink.h"
+#include "comparisonengine.h"
+#include "decryptor.h"
+#include "fhewcomparator.h"
+#include "keyceremony.h"
+#include "party.h"
+#include "threadpool.h"
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace lbcrypto;
+
+struct PipelineParams {
+    // "ckks", or "bgv"/"bfv" for exact integer aggregation; the threshold
+    // check (EvaluateThreshold) needs CKKS
+    std::string scheme = "ckks";
+
+    usint numParties     = 5;
+    usint batchSize      = 16;
+    // 0 derives the depth the threshold check needs (see GetComparisonDepth)
+    usint multDepth      = 0;
+    usint scalingModSize = 50;
+    SecurityLevel securityLevel = HEStd_128_classic;
+    // 0 lets OpenFHE pick the smallest secure ring dimension
+    usint ringDim = 0;
+    KeySwitchTechnique keySwitchTechnique = HYBRID;
+    // parties OpenFHE budgets the threshold decryption noise for; 0 uses numParties
+    usint thresholdParties = 0;
+
+    // values contributed by every party, encoded into consecutive slots
+    usint metricsPerParty = 1;
+
+    // worker threads for per-party work; 0 uses all hardware threads
+    usint numThreads = 0;
+
+    // directory the parties' FHE ciphertexts are serialized to (see FileSink);
+    // empty disables it unless a sink is installed with SetCiphertextSink
+    std::string dataFolder;
+    // single container file the ciphertexts are appended to instead (see
+    // ContainerWriter); takes precedence over dataFolder
+    std::string containerPath;
+    // background threads writing the ciphertexts, and whether the output is fsync'ed
+    usint numWriters = 1;
+    bool syncWrites  = true;
+
+    // mod-reduce the party ciphertexts to the lowest level the threshold check
+    // needs and write them in the compact wire format (see CompactCodec)
+    bool compactWire = false;
+
+    // directory of the persistent key store (see KeyStore); empty disables it
+    std::string keyStoreDir;
+
+    // secret-share every party's key so that up to numParties - GetThreshold()
+    // simultaneous dropouts ("shamir") or a single one ("additive") can be tolerated
+    bool faultTolerant = false;
+    std::string shareType = "shamir";
+
+    // every party Shamir-shares its key, so that any GetThreshold() parties can
+    // decrypt with Lagrange-weighted shares of the joint key and no secret key is
+    // ever reconstructed (see Decryptor::LagrangeWeightedKey); needs "shamir"
+    bool thresholdDecryption = false;
+
+    // range of the aggregate and of the thresholds, and the Chebyshev degree of
+    // the cached ReLU approximation behind the "max" threshold check (see
+    // ComparisonEngine); 0 picks the smallest degree that approximates ReLU on
+    // the bounds within ComparisonEngine::MAX_RELU_ERROR (59 for these bounds)
+    double lowerBound  = 0;
+    double upperBound  = 40;
+    uint32_t polyDegree = 0;
+
+    // threshold check kernel: "max" evaluates max(floor(threshold), x) with the ReLU
+    // series, "sign" only the decision x > threshold with signIterations rounds
+    // of the composite sign polynomial, at a fraction of the depth, and "fhew"
+    // decides it exactly for the first metricsPerParty slots by switching to
+    // FHEW (see FhewComparator)
+    std::string comparison  = "max";
+    uint32_t signIterations = 1;
+
+    // "fhew" only: the switching keys are generated from the joint secret key,
+    // the sum of all party secrets, by a trusted dealer at setup; without this
+    // opt-in no secret key but a party's own is ever formed
+    bool dealerSchemeSwitching = false;
+
+    // largest value a party contributes; BGV/BFV size the plaintext modulus to
+    // hold numParties * maxValue (upperBound if 0)
+    int64_t maxValue = 0;
+};
+
+/**
+ * SA to FHE conversion for a runtime number of parties: crypto context and
+ * joint key generation, per-party encoding and encryption, aggregation,
+ * homomorphic threshold check and (fault tolerant) threshold decryption.
+ * Everything but the threshold check works on CKKS, BGV and BFV contexts alike.
+ */
+class SchemeSwitchPipeline {
+public:
+    explicit SchemeSwitchPipeline(const PipelineParams& params);
+
+    /**
+     * Warm start from the key store in params.keyStoreDir if it holds keys for
+     * these parameters; otherwise GenerateContext() and GenerateKeys(), saving
+     * the result to the key store (if one is configured).
+     * @return true if the key material was loaded from the store
+     */
+    bool Setup();
+
+    void GenerateContext();
+
+    /**
+     * Joint public key generation for all parties (see KeyCeremony). The eval
+     * keys are generated on first use, or up front by GenerateEvalKeys().
+     */
+    void GenerateKeys();
+
+    /**
+     * Eval keys the configured computation needs: the eval-mult key for the
+     * CKKS threshold check. Aggregation only adds, so it needs no EvalSum or
+     * rotation keys.
+     */
+    EvalKeyPlan GetEvalKeyPlan() const;
+
+    /**
+     * Generates the keys of GetEvalKeyPlan() that do not exist yet. Call it
+     * after Setup() to keep the key generation out of the first query, or when
+     * several threads share the pipeline: lazily generated keys are inserted
+     * into the crypto context while other queries may read it.
+     */
+    void GenerateEvalKeys();
+
+    // eval keys generated (or loaded from the key store) for the joint key so far
+    EvalKeyPlan GetGeneratedEvalKeys() const;
+
+    /**
+     * Assigns the SA value of every party; values.size() must equal the number of parties.
+     */
+    void SetValues(const std::vector<int64_t>& values);
+
+    /**
+     * Assigns params.metricsPerParty SA values to every party.
+     */
+    void SetMetrics(const std::vector<std::vector<int64_t>>& metrics);
+
+    /**
+     * Replaces the ContainerSink on params.containerPath or the FileSink on
+     * params.dataFolder as destination of the
+     * ciphertexts produced by EncryptAll.
+     */
+    void SetCiphertextSink(std::unique_ptr<CiphertextSink> ciphertextSink);
+
+    /**
+     * Encodes and encrypts every party's value concurrently and hands each
+     * ciphertext to the ciphertext sink (if any) as soon as it is ready.
+     * Returns once the sink flushed all of them; write errors are rethrown.
+     * @return one ciphertext per party, in party order
+     */
+    std::vector<Ciphertext<DCRTPoly>> EncryptAll();
+
+    /**
+     * Aggregates the ciphertexts of all parties that are not in faulted;
+     * metric j of the aggregate is in slot j.
+     * @param faulted - 0-based indices of parties that dropped out
+     */
+    Ciphertext<DCRTPoly> Aggregate(const std::vector<Ciphertext<DCRTPoly>>& ciphertexts,
+                                   const std::set<usint>& faulted = {}) const;
+
+    /**
+     * Streams the ciphertexts serialized to folder into the aggregate without
+     * keeping them in memory (see StreamingAggregator). Waits up to timeout for
+     * expected files to appear.
+     */
+    Ciphertext<DCRTPoly> AggregateFromFolder(const std::string& folder, size_t expected,
+                                             std::chrono::milliseconds timeout) const;
+
+    /**
+     * Aggregates all ciphertexts of a container written for the joint public
+     * key, decoding them from the memory-mapped file.
+     */
+    Ciphertext<DCRTPoly> AggregateFromContainer(const std::string& path) const;
+
+    /**
+     * Homomorphically evaluates max(floor(threshold), x) on the aggregate, or with
+     * params.comparison "sign" or "fhew" a value that is positive iff x > threshold,
+     * with the comparison engine set up by Setup() or GenerateContext(). The
+     * FHEW switching keys are generated by Setup(). An integer aggregate exceeds
+     * threshold iff it exceeds floor(threshold), and against an integer the ReLU
+     * error at the kink (at most ComparisonEngine::MAX_RELU_ERROR) leaves every
+     * x on its side of floor(threshold) + 0.5.
+     */
+    Ciphertext<DCRTPoly> EvaluateThreshold(const Ciphertext<DCRTPoly>& aggregate, double threshold) const;
+
+    /**
+     * Decides x > threshold from the decrypted first slot of EvaluateThreshold's
+     * result for the configured comparison kernel.
+     */
+    bool IsAboveThreshold(double value, double threshold) const;
+
+    /**
+     * Rebuilds the secret keys of the faulted parties concurrently, each from the
+     * shares held by the parties that neither faulted nor are unavailable.
+     * @param unavailable - further parties whose shares cannot be collected
+     * @return recovered secret key per faulted party index
+     */
+    std::map<usint, PrivateKey<DCRTPoly>> RecoverKeys(const std::set<usint>& faulted,
+                                                      const std::set<usint>& unavailable = {}) const;
+
+    /**
+     * Threshold decryption by all parties. The secret keys of faulted parties
+     * are recovered from their shares first (see RecoverKeys). With
+     * params.thresholdDecryption only the first GetThreshold() parties that did
+     * not fault take part, each with its Lagrange-weighted joint key share.
+     */
+    Plaintext Decrypt(const Ciphertext<DCRTPoly>& ciphertext, const std::set<usint>& faulted = {}) const;
+
+    /**
+     * Threshold decryption of many result ciphertexts in one pass (see
+     * Decryptor::DecryptBatch); keys of faulted parties are recovered once.
+     */
+    std::vector<Plaintext> DecryptBatch(const std::vector<Ciphertext<DCRTPoly>>& ciphertexts,
+                                        const std::set<usint>& faulted = {}) const;
+
+    const PipelineParams& GetParams() const {
+        return params;
+    }
+
+    const CryptoContext<DCRTPoly>& GetCryptoContext() const {
+        return cc;
+    }
+
+    const PublicKey<DCRTPoly>& GetJointPublicKey() const {
+        return jointPublicKey;
+    }
+
+    const std::vector<Party>& GetParties() const {
+        return parties;
+    }
+
+
+    ThreadPool& GetThreadPool() const {
+        return *pool;
+    }
+
+    // bytes and time spent writing ciphertexts so far; empty without a sink
+    SinkStats GetSinkStats() const {
+        return sink ? sink->GetStats() : SinkStats();
+    }
+
+    // levels the threshold check consumes with params.comparison
+    usint GetComparisonDepth() const {
+        if (params.comparison == "fhew") {
+            return FhewComparator::SwitchingDepth();
+        }
+        return (params.comparison == "sign") ? ComparisonEngine::SignDepth(params.signIterations)
+                                             : ComparisonEngine::ChebyshevDepth(params.polyDegree);
+    }
+
+    // Shamir reconstruction threshold: a strict majority of the parties
+    usint GetThreshold() const {
+        return params.numParties / 2 + 1;
+    }
+
+    // number of missing parties whose keys RecoverKeys can rebuild; additive
+    // shares are held by all other parties and are all needed
+    usint GetMaxRecoverable() const {
+        if (!params.faultTolerant) {
+            return 0;
+        }
+        return (params.shareType == "additive") ? 1 : params.numParties - GetThreshold();
+    }
+
+private:
+    // the decryption keys and, in partyIds, the ids of the parties holding them
+    std::vector<PrivateKey<DCRTPoly>> DecryptionKeys(const std::set<usint>& faulted,
+                                                     std::vector<uint32_t>& partyIds) const;
+
+    std::vector<PrivateKey<DCRTPoly>> ThresholdDecryptionKeys(const Decryptor& decryptor, const std::set<usint>& faulted,
+                                                              std::vector<uint32_t>& partyIds) const;
+
+    // generates the keys of needed that do not exist yet, once
+    void EnsureEvalKeys(const EvalKeyPlan& needed) const;
+
+    void ShareKeys();
+
+    void InitComparison();
+
+    void InitSchemeSwitching();
+
+    void CombineJointKeyShares();
+
+    PipelineParams params;
+    std::unique_ptr<ThreadPool> pool;
+    CryptoContext<DCRTPoly> cc;
+    std::vector<Party> parties;
+    PublicKey<DCRTPoly> jointPublicKey;
+    std::unique_ptr<CiphertextSink> sink;
+    std::unique_ptr<ComparisonEngine> comparison;
+    std::unique_ptr<FhewComparator> fhewComparator;
+    mutable std::mutex evalKeyMtx;
+    mutable EvalKeyPlan evalKeys;
+};
+
+#endif  //OPENFHE_PIPELINE_H
@@ -0,0 +1,118 @@
+#include "queryrunner.h"
+#include "tracer.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+
+namespace {
+
+double MsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+}  // namespace
+
+QueryRunner::QueryRunner(const SchemeSwitchPipeline& pipeline, const std::vector<Ciphertext<DCRTPoly>>& ciphertexts,
+                         const std::set<usint>& faulted, size_t maxCachedAggregates,
+                         std::chrono::milliseconds decryptionDeadline)
+    : pipeline(pipeline),
+      ciphertexts(ciphertexts),
+      faulted(faulted),
+      maxCachedAggregates(maxCachedAggregates),
+      coordinator(pipeline, decryptionDeadline),
+      source(DecryptionCoordinator::LocalSource(pipeline, faulted)) {
+    if (ciphertexts.size() != pipeline.GetParams().numParties) {
+        OPENFHE_THROW(config_error, "Expected one ciphertext per party");
+    }
+}
+
+bool QueryRunner::ParseQuery(const std::string& line, usint numParties, ThresholdQuery& query) {
+    std::istringstream ss(line.substr(0, line.find('#')));
+    std::string threshold;
+    if (!(ss >> threshold)) {
+        return false;
+    }
+
+    query = ThresholdQuery();
+    char* end       = nullptr;
+    query.threshold = std::strtod(threshold.c_str(), &end);
+    if (*end != '\0' || !std::isfinite(query.threshold)) {
+        OPENFHE_THROW(config_error, "Invalid threshold \"" + threshold + "\"");
+    }
+
+    std::string parties, extra;
+    if (ss >> parties) {
+        std::istringstream list(parties);
+        std::string id;
+        while (std::getline(list, id, ',')) {
+            const unsigned long party = std::strtoul(id.c_str(), &end, 10);
+            if (id.empty() || *end != '\0' || party < 1 || party > numParties) {
+                OPENFHE_THROW(config_error, "Invalid party \"" + id + "\"; expected 1 to " + std::to_string(numParties));
+            }
+            query.parties.insert(static_cast<usint>(party - 1));
+        }
+    }
+    if (ss >> extra) {
+        OPENFHE_THROW(config_error, "Unexpected \"" + extra + "\" after the party list");
+    }
+    return true;
+}
+
+QueryResult QueryRunner::Run(const ThresholdQuery& query) {
+    TraceScope scope("query");
+    const auto start = std::chrono::steady_clock::now();
+
+    QueryResult result;
+    auto aggregate = GetAggregate(query.parties, result.aggregated);
+    auto check     = pipeline.EvaluateThreshold(aggregate, query.threshold);
+    result.value   = Decrypt(check)->GetRealPackedValue()[0];
+
+    result.crossed = pipeline.IsAboveThreshold(result.value, query.threshold);
+
+    result.latencyMs = MsSince(start);
+    stats.latenciesMs.push_back(result.latencyMs);
+    return result;
+}
+
+Plaintext QueryRunner::Decrypt(const Ciphertext<DCRTPoly>& ct) {
+    const PipelineParams& params = pipeline.GetParams();
+    // t-of-N decryption needs no recovery: any GetThreshold() parties decrypt
+    if (params.faultTolerant && !params.thresholdDecryption) {
+        return coordinator.Decrypt(ct, source);
+    }
+    return pipeline.Decrypt(ct, faulted);
+}
+
+Ciphertext<DCRTPoly> QueryRunner::GetAggregate(const std::set<usint>& parties, bool& aggregated) {
+    std::set<usint> excluded = faulted;
+    if (!parties.empty()) {
+        for (usint i = 0; i < ciphertexts.size(); ++i) {
+            if (parties.count(i) == 0) {
+                excluded.insert(i);
+            }
+            else if (faulted.count(i) != 0) {
+                OPENFHE_THROW(config_error, "Party " + std::to_string(i + 1) + " dropped out of this key epoch");
+            }
+        }
+    }
+
+    auto cached = aggregates.find(excluded);
+    if (cached != aggregates.end()) {
+        aggregated = false;
+        return cached->second;
+    }
+
+    aggregated     = true;
+    auto aggregate = pipeline.Aggregate(ciphertexts, excluded);
+    if (maxCachedAggregates > 0) {
+        if (aggregates.size() >= maxCachedAggregates) {
+            aggregates.erase(cacheOrder.front());
+            cacheOrder.pop_front();
+        }
+        aggregates[excluded] = aggregate;
+        cacheOrder.push_back(excluded);
+    }
+    return aggregate;
+}
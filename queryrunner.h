@@ -0,0 +1,99 @@
+#ifndef OPENFHE_QUERYRUNNER_H
+#define OPENFHE_QUERYRUNNER_H
+
+#include "openfhe.h"
+
+#include "decryptioncoordinator.h"
+#include "pipeline.h"
+
+#include <chrono>
+#include <deque>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace lbcrypto;
+
+/**
+ * One threshold check: does the sum of the values of parties exceed threshold?
+ */
+struct ThresholdQuery {
+    // 0-based indices of the aggregated parties; empty for all that did not fault
+    std::set<usint> parties;
+    double threshold = 0;
+};
+
+struct QueryResult {
+    bool crossed = false;
+    // decrypted output of the threshold check (see SchemeSwitchPipeline::EvaluateThreshold)
+    double value     = 0;
+    double latencyMs = 0;
+    // whether the aggregate of the party set had to be computed for this query
+    bool aggregated = false;
+};
+
+/**
+ * Evaluates a stream of threshold queries within one key epoch. The parties'
+ * ciphertexts are encrypted once, the aggregates of the last
+ * maxCachedAggregates party sets are kept, and a query otherwise only pays for
+ * the threshold check and the threshold decryption. With params.faultTolerant
+ * the decryption goes through a DecryptionCoordinator, which recovers the keys
+ * of the faulted parties when they fail to answer.
+ */
+class QueryRunner {
+public:
+    /**
+     * @param pipeline - set up with the keys of the epoch
+     * @param ciphertexts - one ciphertext per party (see SchemeSwitchPipeline::EncryptAll)
+     * @param faulted - 0-based indices of parties that dropped out for the whole epoch
+     * @param maxCachedAggregates - party sets whose aggregate is kept
+     * @param decryptionDeadline - wait for the partial decryptions before recovering keys
+     */
+    QueryRunner(const SchemeSwitchPipeline& pipeline, const std::vector<Ciphertext<DCRTPoly>>& ciphertexts,
+                const std::set<usint>& faulted = {}, size_t maxCachedAggregates = 64,
+                std::chrono::milliseconds decryptionDeadline = std::chrono::milliseconds(1000));
+
+    /**
+     * Parses "<threshold> [<party>,<party>,...]" with 1-based party ids into
+     * query. Returns false for empty lines and # comments; throws config_error
+     * on malformed lines.
+     */
+    static bool ParseQuery(const std::string& line, usint numParties, ThresholdQuery& query);
+
+    /**
+     * Aggregates the query's parties (or takes the cached aggregate), evaluates
+     * the threshold check and decrypts it.
+     */
+    QueryResult Run(const ThresholdQuery& query);
+
+    // latency of every query run so far
+    const LatencyStats& GetStats() const {
+        return stats;
+    }
+
+    // latency and key recoveries of the coordinated decryptions so far
+    LatencyStats GetDecryptionStats() const {
+        return coordinator.GetStats();
+    }
+
+private:
+    Ciphertext<DCRTPoly> GetAggregate(const std::set<usint>& parties, bool& aggregated);
+
+    // through the coordinator with fault tolerance, otherwise SchemeSwitchPipeline::Decrypt
+    Plaintext Decrypt(const Ciphertext<DCRTPoly>& ct);
+
+    const SchemeSwitchPipeline& pipeline;
+    std::vector<Ciphertext<DCRTPoly>> ciphertexts;
+    std::set<usint> faulted;
+    size_t maxCachedAggregates;
+    std::map<std::set<usint>, Ciphertext<DCRTPoly>> aggregates;
+    // cached party sets, oldest first
+    std::deque<std::set<usint>> cacheOrder;
+    LatencyStats stats;
+    DecryptionCoordinator coordinator;
+    // the faulted parties never answer
+    DecryptionCoordinator::PartialSource source;
+};
+
+#endif  //OPENFHE_QUERYRUNNER_H
@@ -0,0 +1,224 @@
+#include "streamingaggregator.h"
+#include "compactciphertext.h"
+#include "tracer.h"
+
+// header files needed for serialization
+#include "ciphertext-ser.h"
+#include "scheme/bfvrns/bfvrns-ser.h"
+#include "scheme/bgvrns/bgvrns-ser.h"
+#include "scheme/ckksrns/ckksrns-ser.h"
+
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <set>
+#include <sstream>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Reads exactly size bytes; returns false on end of file before the first byte.
+bool ReadFully(int fd, char* buffer, size_t size) {
+    size_t done = 0;
+    while (done < size) {
+        ssize_t n = ::read(fd, buffer + done, size - done);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            OPENFHE_THROW(openfhe_error, std::string("Error reading ciphertext stream: ") + std::strerror(errno));
+        }
+        if (n == 0) {
+            if (done == 0) {
+                return false;
+            }
+            OPENFHE_THROW(openfhe_error, "Ciphertext stream ended inside a frame");
+        }
+        done += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+void WriteFully(int fd, const char* buffer, size_t size) {
+    size_t done = 0;
+    while (done < size) {
+        ssize_t n = ::write(fd, buffer + done, size - done);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            OPENFHE_THROW(openfhe_error, std::string("Error writing ciphertext stream: ") + std::strerror(errno));
+        }
+        done += static_cast<size_t>(n);
+    }
+}
+
+}  // namespace
+
+StreamingAggregator::StreamingAggregator(const CryptoContext<DCRTPoly>& cc, ThreadPool& pool, size_t maxInFlight)
+    : cc(cc), pool(pool), maxInFlight(maxInFlight == 0 ? pool.Size() : maxInFlight) {}
+
+StreamingAggregator::~StreamingAggregator() {
+    WaitIdle();
+}
+
+void StreamingAggregator::AddFile(const std::string& path) {
+    Enqueue([this, path] {
+        std::ifstream ifs(path, std::ios::in | std::ios::binary);
+        if (!ifs.is_open()) {
+            OPENFHE_THROW(openfhe_error, "Error reading ciphertext " + path);
+        }
+        return DecodeCiphertext(cc, std::string(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>()));
+    });
+}
+
+void StreamingAggregator::AddSerialized(std::string bytes) {
+    Enqueue([this, bytes = std::move(bytes)] { return DecodeCiphertext(cc, bytes); });
+}
+
+size_t StreamingAggregator::ConsumeContainer(const ContainerReader& container) {
+    for (size_t i = 0; i < container.Size(); ++i) {
+        Enqueue([this, bytes = container.GetBytes(i)] { return DecodeCiphertext(cc, bytes); });
+    }
+    return container.Size();
+}
+
+size_t StreamingAggregator::ConsumeDirectory(const std::string& directory, size_t expected,
+                                             std::chrono::milliseconds timeout, const std::string& prefix,
+                                             std::chrono::milliseconds pollInterval) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    std::set<std::string> seen;
+
+    for (;;) {
+        for (const auto& entry : fs::directory_iterator(directory)) {
+            const std::string name = entry.path().filename().string();
+            if (!entry.is_regular_file() || name.compare(0, prefix.size(), prefix) != 0 || seen.count(name) != 0) {
+                continue;
+            }
+            seen.insert(name);
+            AddFile(entry.path().string());
+            if (seen.size() == expected) {
+                return seen.size();
+            }
+        }
+        if (std::chrono::steady_clock::now() >= deadline) {
+            return seen.size();
+        }
+        std::this_thread::sleep_for(pollInterval);
+    }
+}
+
+size_t StreamingAggregator::ConsumeFd(int fd) {
+    size_t count = 0;
+    uint64_t size;
+    while (ReadFully(fd, reinterpret_cast<char*>(&size), sizeof(size))) {
+        std::string bytes(size, '\0');
+        if (size > 0 && !ReadFully(fd, &bytes[0], size)) {
+            OPENFHE_THROW(openfhe_error, "Ciphertext stream ended inside a frame");
+        }
+        AddSerialized(std::move(bytes));
+        ++count;
+    }
+    return count;
+}
+
+void StreamingAggregator::WriteFrame(int fd, const Ciphertext<DCRTPoly>& ct) {
+    std::ostringstream os;
+    Serial::Serialize(ct, os, SerType::BINARY);
+    const std::string bytes = os.str();
+    uint64_t size           = bytes.size();
+    WriteFully(fd, reinterpret_cast<const char*>(&size), sizeof(size));
+    WriteFully(fd, bytes.data(), bytes.size());
+}
+
+Ciphertext<DCRTPoly> StreamingAggregator::Finalize() {
+    WaitIdle();
+
+    std::vector<Ciphertext<DCRTPoly>> partialSums;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (error) {
+            auto e = error;
+            error  = nullptr;
+            accumulators.clear();
+            numFolded = 0;
+            std::rethrow_exception(e);
+        }
+        partialSums.swap(accumulators);
+        numFolded = 0;
+    }
+    if (partialSums.empty()) {
+        OPENFHE_THROW(openfhe_error, "No ciphertexts to aggregate");
+    }
+
+    Ciphertext<DCRTPoly> result = partialSums[0];
+    for (size_t i = 1; i < partialSums.size(); ++i) {
+        cc->EvalAddInPlace(result, partialSums[i]);
+    }
+    return result;
+}
+
+size_t StreamingAggregator::GetNumFolded() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return numFolded;
+}
+
+void StreamingAggregator::Enqueue(std::function<Ciphertext<DCRTPoly>()> load) {
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        cv.wait(lock, [this] { return inFlight < maxInFlight; });
+        ++inFlight;
+    }
+
+    pool.Submit([this, load = std::move(load)] {
+        try {
+            Fold(load());
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(mtx);
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+        // notify under the lock: once inFlight reaches 0, WaitIdle may return and
+        // the aggregator (cv included) be destroyed as soon as the lock is released
+        std::lock_guard<std::mutex> lock(mtx);
+        --inFlight;
+        cv.notify_all();
+    });
+}
+
+void StreamingAggregator::Fold(Ciphertext<DCRTPoly> ciphertext) {
+    TraceScope scope("fold");
+    Ciphertext<DCRTPoly> acc;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (!accumulators.empty()) {
+            acc = std::move(accumulators.back());
+            accumulators.pop_back();
+        }
+    }
+
+    // A freshly deserialized ciphertext is owned by us and can serve as accumulator.
+    if (acc == nullptr) {
+        acc = std::move(ciphertext);
+    }
+    else {
+        cc->EvalAddInPlace(acc, ciphertext);
+    }
+
+    std::lock_guard<std::mutex> lock(mtx);
+    accumulators.push_back(std::move(acc));
+    ++numFolded;
+}
+
+void StreamingAggregator::WaitIdle() {
+    std::unique_lock<std::mutex> lock(mtx);
+    cv.wait(lock, [this] { return inFlight == 0; });
+}
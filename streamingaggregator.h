@@ -0,0 +1,112 @@
+#ifndef OPENFHE_STREAMINGAGGREGATOR_H
+#define OPENFHE_STREAMINGAGGREGATOR_H
+
+#include "openfhe.h"
+
+#include "ciphertextcontainer.h"
+#include "threadpool.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace lbcrypto;
+
+/**
+ * Aggregates serialized party ciphertexts as they arrive instead of holding all
+ * N of them in memory. Every submitted ciphertext is deserialized on a pool
+ * worker and immediately added into one of at most maxInFlight running
+ * accumulators; Submit blocks while maxInFlight ciphertexts are being
+ * processed. Peak memory is therefore O(maxInFlight) ciphertexts, independent
+ * of the number of parties.
+ *
+ * The Add and Consume methods must be called from one thread that is not a
+ * worker of the pool.
+ */
+class StreamingAggregator {
+public:
+    /**
+     * @param maxInFlight - ciphertexts deserialized/added concurrently; 0 uses the pool size
+     */
+    StreamingAggregator(const CryptoContext<DCRTPoly>& cc, ThreadPool& pool, size_t maxInFlight = 0);
+
+    // waits for the ciphertexts still in flight
+    ~StreamingAggregator();
+
+    StreamingAggregator(const StreamingAggregator&)            = delete;
+    StreamingAggregator& operator=(const StreamingAggregator&) = delete;
+
+    /**
+     * Folds in a ciphertext serialized with Serial::SerializeToFile(..., SerType::BINARY)
+     * or with CompactCodec::Export.
+     */
+    void AddFile(const std::string& path);
+
+    /**
+     * Folds in a ciphertext serialized with Serial::Serialize(..., SerType::BINARY)
+     * or with CompactCodec::Export.
+     */
+    void AddSerialized(std::string bytes);
+
+    /**
+     * Polls directory for regular files whose name starts with prefix and folds
+     * each new one in, until expected files were consumed or timeout expired.
+     * Producers must create the files atomically (write elsewhere, then rename).
+     * @return number of files consumed
+     */
+    size_t ConsumeDirectory(const std::string& directory, size_t expected, std::chrono::milliseconds timeout,
+                            const std::string& prefix              = "ciphertext",
+                            std::chrono::milliseconds pollInterval = std::chrono::milliseconds(10));
+
+    /**
+     * Folds in every ciphertext of container, decoding them straight from its
+     * mapping. container must stay open until Finalize() returned.
+     * @return number of ciphertexts consumed
+     */
+    size_t ConsumeContainer(const ContainerReader& container);
+
+    /**
+     * Reads frames written by WriteFrame from fd until end of file.
+     * @return number of ciphertexts consumed
+     */
+    size_t ConsumeFd(int fd);
+
+    /**
+     * Writes ct to fd as a frame: 64-bit byte count followed by the binary serialization.
+     */
+    static void WriteFrame(int fd, const Ciphertext<DCRTPoly>& ct);
+
+    /**
+     * Waits for all submitted ciphertexts and returns their sum. Rethrows the
+     * first error raised while deserializing or adding. The aggregator is empty
+     * afterwards and can be reused.
+     */
+    Ciphertext<DCRTPoly> Finalize();
+
+    size_t GetNumFolded() const;
+
+private:
+    void Enqueue(std::function<Ciphertext<DCRTPoly>()> load);
+
+    void Fold(Ciphertext<DCRTPoly> ciphertext);
+
+    void WaitIdle();
+
+    CryptoContext<DCRTPoly> cc;
+    ThreadPool& pool;
+    size_t maxInFlight;
+
+    mutable std::mutex mtx;
+    std::condition_variable cv;
+    size_t inFlight  = 0;
+    size_t numFolded = 0;
+    // accumulators not currently used by a worker
+    std::vector<Ciphertext<DCRTPoly>> accumulators;
+    std::exception_ptr error;
+};
+
+#endif  //OPENFHE_STREAMINGAGGREGATOR_H
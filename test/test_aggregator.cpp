@@ -0,0 +1,68 @@
+#include "openfhe.h"
+
+#include "aggregator.h"
+#include "pipeline.h"
+#include "testing.h"
+
+using namespace lbcrypto;
+
+// Aggregation round trips: the threshold-decrypted aggregate equals the sum of
+// the values of the aggregated parties, for the chain, the tree and the
+// pipeline with dropped parties, on CKKS and BGV.
+
+void TestCKKSAggregate() {
+    const usint numParties = 5;
+    SchemeSwitchPipeline pipeline(TestParams(numParties));
+    pipeline.Setup();
+    pipeline.SetValues(TestValues(numParties));
+    auto ciphertexts = pipeline.EncryptAll();
+
+    Aggregator aggregator(pipeline.GetCryptoContext(), &pipeline.GetThreadPool());
+    auto linear = pipeline.Decrypt(aggregator.AggregateLinear(ciphertexts))->GetRealPackedValue();
+    auto tree   = pipeline.Decrypt(aggregator.AggregateTree(ciphertexts))->GetRealPackedValue();
+    CHECK(Near(linear[0], 15));
+    CHECK(Near(tree[0], 15));
+    CHECK(Near(tree[1], 0));
+
+    // parties 2 and 4 dropped out before uploading
+    auto partial = pipeline.Decrypt(pipeline.Aggregate(ciphertexts, {1, 3}))->GetRealPackedValue();
+    CHECK(Near(partial[0], 1 + 3 + 5));
+
+    // the inputs are left alone
+    CHECK(Near(pipeline.Decrypt(ciphertexts[1])->GetRealPackedValue()[0], 2));
+}
+
+void TestCKKSMetrics() {
+    const usint numParties  = 3;
+    PipelineParams params   = TestParams(numParties);
+    params.metricsPerParty  = 4;
+    SchemeSwitchPipeline pipeline(params);
+    pipeline.Setup();
+    pipeline.SetMetrics({{1, 2, 3, 4}, {10, 20, 30, 40}, {100, 200, 300, 400}});
+
+    auto slots = pipeline.Decrypt(pipeline.Aggregate(pipeline.EncryptAll()))->GetRealPackedValue();
+    CHECK(Near(slots[0], 111));
+    CHECK(Near(slots[1], 222));
+    CHECK(Near(slots[2], 333));
+    CHECK(Near(slots[3], 444));
+}
+
+void TestBGVAggregate() {
+    const usint numParties = 4;
+    PipelineParams params  = TestParams(numParties);
+    params.scheme          = "bgv";
+    params.maxValue        = numParties;
+    SchemeSwitchPipeline pipeline(params);
+    pipeline.Setup();
+    pipeline.SetValues(TestValues(numParties));
+
+    auto aggregate = pipeline.Aggregate(pipeline.EncryptAll(), {0});
+    CHECK(pipeline.Decrypt(aggregate)->GetPackedValue()[0] == 2 + 3 + 4);
+}
+
+int main() {
+    TestCKKSAggregate();
+    TestCKKSMetrics();
+    TestBGVAggregate();
+    return TestResult();
+}
@@ -0,0 +1,70 @@
+#include "openfhe.h"
+
+#include "compactciphertext.h"
+#include "encoder.h"
+#include "testing.h"
+
+// header files needed for serialization
+#include "ciphertext-ser.h"
+#include "scheme/ckksrns/ckksrns-ser.h"
+
+using namespace lbcrypto;
+
+// CompactCodec round trips: exported ciphertexts import to ciphertexts that
+// decrypt to the same values, at full level and after dropping levels, and
+// both wire formats decode through DecodeCiphertext.
+
+const uint32_t MULT_DEPTH = 6;
+
+double DecryptSlot0(const CryptoContext<DCRTPoly>& cc, const PrivateKey<DCRTPoly>& secretKey,
+                    const Ciphertext<DCRTPoly>& ct) {
+    Plaintext result;
+    cc->Decrypt(ct, secretKey, &result);
+    return result->GetRealPackedValue()[0];
+}
+
+int main() {
+    const usint batchSize = 16;
+    CCParams<CryptoContextCKKSRNS> parameters;
+    parameters.SetSecurityLevel(HEStd_NotSet);
+    parameters.SetRingDim(1024);
+    parameters.SetMultiplicativeDepth(MULT_DEPTH);
+    parameters.SetScalingModSize(50);
+    parameters.SetBatchSize(batchSize);
+    CryptoContext<DCRTPoly> cc = GenCryptoContext(parameters);
+    cc->Enable(PKE);
+    cc->Enable(KEYSWITCH);
+    cc->Enable(LEVELEDSHE);
+
+    auto keys = cc->KeyGen();
+    SAEncoder encoder(cc, batchSize);
+    auto ciphertext = cc->Encrypt(keys.publicKey, encoder.Encode(int64_t(-9)));
+
+    CompactCodec codec(cc);
+    for (size_t levelsToDrop : {0, 1, 4}) {
+        auto reduced            = (levelsToDrop > 0) ? cc->LevelReduce(ciphertext, nullptr, levelsToDrop) : ciphertext;
+        const std::string bytes = codec.Export(reduced);
+        CHECK(CompactCodec::IsCompact(bytes));
+        auto imported = codec.Import(bytes);
+        CHECK(imported->GetLevel() == ciphertext->GetLevel() + levelsToDrop);
+        CHECK(imported->GetKeyTag() == ciphertext->GetKeyTag());
+        CHECK(Near(DecryptSlot0(cc, keys.secretKey, imported), -9));
+
+        // dropped towers are not stored
+        if (levelsToDrop > 0) {
+            CHECK(bytes.size() < codec.Export(ciphertext).size());
+        }
+        CHECK_THROWS(codec.Import(bytes.substr(0, bytes.size() / 2)));
+    }
+    CHECK(CompactCodec::LevelsToDrop(MULT_DEPTH, 2) == MULT_DEPTH - 2);
+    CHECK(CompactCodec::LevelsToDrop(MULT_DEPTH, MULT_DEPTH + 1) == 0);
+
+    std::stringstream binary;
+    Serial::Serialize(ciphertext, binary, SerType::BINARY);
+    const std::string serialized = binary.str();
+    CHECK(!CompactCodec::IsCompact(serialized));
+    CHECK(Near(DecryptSlot0(cc, keys.secretKey, DecodeCiphertext(cc, serialized)), -9));
+    CHECK(Near(DecryptSlot0(cc, keys.secretKey, DecodeCiphertext(cc, EncodeCiphertext(cc, ciphertext, true))), -9));
+
+    return TestResult();
+}
@@ -0,0 +1,79 @@
+#include "openfhe.h"
+
+#include "comparisonengine.h"
+#include "testing.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace lbcrypto;
+
+// ComparisonEngine round trips: EvalMax decrypts to max(threshold, x) within
+// the measured ReLU error, so the slots just below, at and just above an
+// integer threshold land on the right side of threshold + 0.5, and an
+// approximation too coarse for its bounds is rejected.
+
+const double LOWER_BOUND = 0;
+const double UPPER_BOUND = 20;
+
+CryptoContext<DCRTPoly> CKKSContext(usint multDepth, usint batchSize) {
+    CCParams<CryptoContextCKKSRNS> parameters;
+    parameters.SetSecurityLevel(HEStd_NotSet);
+    parameters.SetRingDim(1024);
+    parameters.SetMultiplicativeDepth(multDepth);
+    parameters.SetScalingModSize(50);
+    parameters.SetBatchSize(batchSize);
+    CryptoContext<DCRTPoly> cc = GenCryptoContext(parameters);
+    cc->Enable(PKE);
+    cc->Enable(KEYSWITCH);
+    cc->Enable(LEVELEDSHE);
+    cc->Enable(ADVANCEDSHE);
+    return cc;
+}
+
+void TestReluDegree() {
+    // the degree-27 series on [-40, 40] is off by about 0.7 at the kink
+    CHECK(ComparisonEngine::ReluError(40, 27) > ComparisonEngine::MAX_RELU_ERROR);
+    CHECK(ComparisonEngine::ReluDegree(40) == 59);
+    CHECK(ComparisonEngine::ReluError(40, 59) <= ComparisonEngine::MAX_RELU_ERROR);
+    // half the width, half the degree
+    CHECK(ComparisonEngine::ReluDegree(20) == 27);
+}
+
+void TestEvalMax() {
+    const usint batchSize = 32;
+    const uint32_t degree = ComparisonEngine::ReluDegree(UPPER_BOUND - LOWER_BOUND);
+    const usint multDepth = ComparisonEngine::ChebyshevDepth(degree);
+    auto cc               = CKKSContext(multDepth, batchSize);
+    auto keys             = cc->KeyGen();
+    cc->EvalMultKeyGen(keys.secretKey);
+
+    CHECK_THROWS(ComparisonEngine(cc, LOWER_BOUND, 2 * UPPER_BOUND, degree, multDepth));
+    ComparisonEngine engine(cc, LOWER_BOUND, UPPER_BOUND, degree, multDepth);
+    CHECK(engine.GetReluError() > 0);
+    CHECK(engine.GetReluError() <= ComparisonEngine::MAX_RELU_ERROR);
+
+    // slot x holds x for every x in the bounds
+    std::vector<double> xs(batchSize, 0);
+    for (usint x = 0; x <= UPPER_BOUND; ++x) {
+        xs[x] = x;
+    }
+    auto ct = cc->Encrypt(keys.publicKey, cc->MakeCKKSPackedPlaintext(xs));
+
+    for (int threshold : {1, 10, 19}) {
+        Plaintext result;
+        cc->Decrypt(engine.EvalMax(ct, threshold), keys.secretKey, &result);
+        const auto values = result->GetRealPackedValue();
+        for (int x : {threshold - 1, threshold, threshold + 1}) {
+            const double value = values[x];
+            CHECK(std::abs(value - std::max(threshold, x)) <= engine.GetReluError() + TEST_TOLERANCE);
+            CHECK((value > threshold + 0.5) == (x > threshold));
+        }
+    }
+}
+
+int main() {
+    TestReluDegree();
+    TestEvalMax();
+    return TestResult();
+}
@@ -0,0 +1,87 @@
+#include "openfhe.h"
+
+#include "ciphertextcontainer.h"
+#include "compactciphertext.h"
+#include "pipeline.h"
+#include "testing.h"
+
+#include <filesystem>
+#include <fstream>
+
+using namespace lbcrypto;
+
+// Container round trips: ciphertexts appended to a container decode to the
+// same plaintexts through the index and, for a file whose index is cut short or
+// cut off, through the record scan; the pipeline aggregates straight from a
+// container.
+
+void TestWriteRead(const SchemeSwitchPipeline& pipeline, const std::vector<Ciphertext<DCRTPoly>>& ciphertexts) {
+    const auto& cc            = pipeline.GetCryptoContext();
+    const std::string keyTag  = pipeline.GetJointPublicKey()->GetKeyTag();
+    const std::string path    = TestPath("container.ssct");
+    const uint64_t contextId  = ContainerWriter::ContextId(cc, keyTag);
+    {
+        ContainerWriter writer(path, contextId, false);
+        for (size_t i = 0; i < ciphertexts.size(); ++i) {
+            // alternate between the two wire formats
+            const bool compact = (i % 2 == 1);
+            writer.Append(i + 1, ciphertexts[i]->GetLevel(), compact,
+                          EncodeCiphertext(cc, ciphertexts[i], compact));
+        }
+        writer.Commit();
+    }
+
+    // the last index entry and the footer behind it
+    const size_t entrySize  = 4 + 4 + 4 + 8 + 8;
+    const size_t footerSize = 8 + 4;
+    for (int damage = 0; damage < 3; ++damage) {
+        if (damage == 1) {
+            // an index cut short in front of an intact footer must not be read
+            // past its end; the records stay readable through the scan
+            std::string bytes;
+            {
+                std::ifstream in(path, std::ios::binary);
+                bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+            }
+            bytes.erase(bytes.size() - footerSize - entrySize, entrySize);
+            std::ofstream(path, std::ios::binary | std::ios::trunc).write(bytes.data(), bytes.size());
+        }
+        else if (damage == 2) {
+            // an interrupted index write leaves the records readable
+            std::filesystem::resize_file(path, std::filesystem::file_size(path) - 4);
+        }
+        ContainerReader reader(path);
+        CHECK(reader.GetContextId() == contextId);
+        CHECK(reader.Size() == ciphertexts.size());
+        for (size_t i = 0; i < reader.Size(); ++i) {
+            CHECK(reader.GetEntry(i).partyId == i + 1);
+            CHECK(reader.GetEntry(i).compact == (i % 2 == 1));
+            auto slots = pipeline.Decrypt(reader.Load(cc, keyTag, i))->GetRealPackedValue();
+            CHECK(Near(slots[0], double(i + 1)));
+        }
+        CHECK_THROWS(reader.Load(cc, keyTag + "-other", 0));
+    }
+    std::filesystem::remove(path);
+}
+
+void TestAggregateFromContainer() {
+    const usint numParties = 4;
+    PipelineParams params  = TestParams(numParties);
+    params.containerPath   = TestPath("epoch.ssct");
+    params.syncWrites      = false;
+    SchemeSwitchPipeline pipeline(params);
+    pipeline.Setup();
+    pipeline.SetValues(TestValues(numParties));
+    auto ciphertexts = pipeline.EncryptAll();
+
+    auto slots = pipeline.Decrypt(pipeline.AggregateFromContainer(params.containerPath))->GetRealPackedValue();
+    CHECK(Near(slots[0], 1 + 2 + 3 + 4));
+
+    TestWriteRead(pipeline, ciphertexts);
+    std::filesystem::remove(params.containerPath);
+}
+
+int main() {
+    TestAggregateFromContainer();
+    return TestResult();
+}
@@ -0,0 +1,200 @@
+#include "openfhe.h"
+
+#include "decryptioncoordinator.h"
+#include "decryptor.h"
+#include "pipeline.h"
+#include "testing.h"
+
+#include <chrono>
+#include <thread>
+
+using namespace lbcrypto;
+
+// Threshold decryption round trips: the partial decryptions of all parties,
+// fused at once, incrementally or in a batch, give the plaintext that the
+// joint secret key decrypts to, also when faulted parties' keys are recovered
+// or only t of the N parties take part.
+
+// the sum of the party secrets, which no party holds
+PrivateKey<DCRTPoly> JointSecretKey(const SchemeSwitchPipeline& pipeline) {
+    const auto& parties  = pipeline.GetParties();
+    DCRTPoly jointSecret = parties[0].GetSecretKey()->GetPrivateElement();
+    for (size_t i = 1; i < parties.size(); ++i) {
+        jointSecret += parties[i].GetSecretKey()->GetPrivateElement();
+    }
+    auto secretKey = std::make_shared<PrivateKeyImpl<DCRTPoly>>(pipeline.GetCryptoContext());
+    secretKey->SetPrivateElement(jointSecret);
+    secretKey->SetKeyTag(pipeline.GetJointPublicKey()->GetKeyTag());
+    return secretKey;
+}
+
+std::vector<double> PlainDecrypt(const SchemeSwitchPipeline& pipeline, const Ciphertext<DCRTPoly>& ct) {
+    Plaintext result;
+    pipeline.GetCryptoContext()->Decrypt(ct, JointSecretKey(pipeline), &result);
+    return result->GetRealPackedValue();
+}
+
+void TestFusion(const SchemeSwitchPipeline& pipeline, const std::vector<Ciphertext<DCRTPoly>>& ciphertexts) {
+    const auto& cc      = pipeline.GetCryptoContext();
+    const auto& parties = pipeline.GetParties();
+    std::vector<PrivateKey<DCRTPoly>> secretKeys;
+    for (const auto& party : parties) {
+        secretKeys.push_back(party.GetSecretKey());
+    }
+
+    Decryptor decryptor(cc, pipeline.GetThreadPool());
+    auto expected = PlainDecrypt(pipeline, ciphertexts[0]);
+    auto slots    = decryptor.Decrypt(ciphertexts[0], secretKeys)->GetRealPackedValue();
+    CHECK(Near(expected[0], 1));
+    CHECK(Near(slots[0], expected[0]));
+
+    // partials folded in as they arrive, lead last
+    FusionAccumulator accumulator(cc, parties.size());
+    for (size_t i = parties.size(); i-- > 1;) {
+        CHECK(!accumulator.Add(cc->MultipartyDecryptMain({ciphertexts[0]}, secretKeys[i])[0]));
+    }
+    CHECK_THROWS(accumulator.Finalize());
+    CHECK(accumulator.Add(cc->MultipartyDecryptLead({ciphertexts[0]}, secretKeys[0])[0]));
+    CHECK(accumulator.IsComplete());
+    CHECK(Near(accumulator.Finalize()->GetRealPackedValue()[0], expected[0]));
+
+    auto plaintexts = decryptor.DecryptBatch(ciphertexts, secretKeys);
+    CHECK(plaintexts.size() == ciphertexts.size());
+    for (size_t i = 0; i < ciphertexts.size(); ++i) {
+        CHECK(Near(plaintexts[i]->GetRealPackedValue()[0], double(i + 1)));
+    }
+}
+
+void TestRecoveredDecryption() {
+    const usint numParties = 5;
+    PipelineParams params  = TestParams(numParties);
+    params.faultTolerant   = true;
+    SchemeSwitchPipeline pipeline(params);
+    pipeline.Setup();
+    pipeline.SetValues(TestValues(numParties));
+    auto ciphertexts = pipeline.EncryptAll();
+
+    TestFusion(pipeline, ciphertexts);
+
+    // party 3 dropped out after uploading; its key is rebuilt from the others' shares
+    auto aggregate = pipeline.Aggregate(ciphertexts);
+    auto expected  = PlainDecrypt(pipeline, aggregate);
+    auto slots     = pipeline.Decrypt(aggregate, {2})->GetRealPackedValue();
+    CHECK(Near(expected[0], 15));
+    CHECK(Near(slots[0], expected[0]));
+
+    // the recovered key's partial decryption stands in for party 3's
+    auto recovered = pipeline.RecoverKeys({2});
+    std::vector<PrivateKey<DCRTPoly>> secretKeys;
+    for (const auto& party : pipeline.GetParties()) {
+        secretKeys.push_back(party.GetSecretKey());
+    }
+    secretKeys[2] = recovered.at(2);
+    Decryptor decryptor(pipeline.GetCryptoContext(), pipeline.GetThreadPool());
+    CHECK(Near(decryptor.Decrypt(aggregate, secretKeys)->GetRealPackedValue()[0], expected[0]));
+}
+
+void TestParallelRecovery() {
+    // GetThreshold() = 4, so up to 3 simultaneous dropouts are recoverable
+    const usint numParties = 7;
+    PipelineParams params  = TestParams(numParties);
+    params.faultTolerant   = true;
+    SchemeSwitchPipeline pipeline(params);
+    pipeline.Setup();
+    pipeline.SetValues(TestValues(numParties));
+    auto aggregate = pipeline.Aggregate(pipeline.EncryptAll());
+    auto expected  = PlainDecrypt(pipeline, aggregate);
+    CHECK(Near(expected[0], 28));
+    CHECK(pipeline.GetMaxRecoverable() == numParties - pipeline.GetThreshold());
+
+    // k = 1 .. N - t parties dropped at once, their keys rebuilt concurrently
+    std::set<usint> faulted;
+    for (usint party : {6, 0, 3}) {
+        faulted.insert(party);
+        CHECK(pipeline.RecoverKeys(faulted).size() == faulted.size());
+        CHECK(Near(pipeline.Decrypt(aggregate, faulted)->GetRealPackedValue()[0], expected[0]));
+    }
+    faulted.insert(1);
+    CHECK_THROWS(pipeline.RecoverKeys(faulted));
+    CHECK_THROWS(pipeline.Decrypt(aggregate, faulted));
+}
+
+void TestAdditiveRecovery() {
+    const usint numParties = 4;
+    PipelineParams params  = TestParams(numParties);
+    params.faultTolerant   = true;
+    params.shareType       = "additive";
+    SchemeSwitchPipeline pipeline(params);
+    pipeline.Setup();
+    pipeline.SetValues(TestValues(numParties));
+    auto aggregate = pipeline.Aggregate(pipeline.EncryptAll());
+    auto expected  = PlainDecrypt(pipeline, aggregate);
+
+    // every other party's share is needed, so only a single dropout is recoverable
+    CHECK(pipeline.GetMaxRecoverable() == 1);
+    CHECK(Near(pipeline.Decrypt(aggregate, {2})->GetRealPackedValue()[0], expected[0]));
+    CHECK_THROWS(pipeline.RecoverKeys({1, 2}));
+    CHECK_THROWS(pipeline.Decrypt(aggregate, {1, 2}));
+}
+
+void TestThresholdDecryption() {
+    const usint numParties     = 5;
+    PipelineParams params      = TestParams(numParties);
+    params.thresholdDecryption = true;
+    SchemeSwitchPipeline pipeline(params);
+    pipeline.Setup();
+    pipeline.SetValues(TestValues(numParties));
+    auto aggregate = pipeline.Aggregate(pipeline.EncryptAll());
+    auto expected  = PlainDecrypt(pipeline, aggregate);
+    CHECK(Near(expected[0], 15));
+
+    // any GetThreshold() = 3 of the 5 parties decrypt with their weighted joint key shares
+    for (const std::set<usint>& faulted : std::vector<std::set<usint>>{{}, {0}, {0, 3}, {1, 4}, {2, 3}}) {
+        auto slots = pipeline.Decrypt(aggregate, faulted)->GetRealPackedValue();
+        CHECK(Near(slots[0], expected[0]));
+        CHECK(Near(slots[1], expected[1]));
+    }
+    CHECK_THROWS(pipeline.Decrypt(aggregate, {0, 1, 2}));
+}
+
+void TestCoordinatedDecryption() {
+    const usint numParties = 5;
+    PipelineParams params  = TestParams(numParties);
+    params.faultTolerant   = true;
+    // a straggling source holds its worker while it sleeps
+    params.numThreads = 2 * numParties;
+    SchemeSwitchPipeline pipeline(params);
+    pipeline.Setup();
+    pipeline.SetValues(TestValues(numParties));
+    auto aggregate = pipeline.Aggregate(pipeline.EncryptAll());
+    auto expected  = PlainDecrypt(pipeline, aggregate);
+
+    DecryptionCoordinator coordinator(pipeline, std::chrono::milliseconds(20));
+    // parties 1 and 4 drop out and are recovered as soon as they report it
+    auto slots = coordinator.Decrypt(aggregate, DecryptionCoordinator::LocalSource(pipeline, {0, 3}))
+                     ->GetRealPackedValue();
+    CHECK(Near(slots[0], expected[0]));
+    CHECK(coordinator.GetStats().recoveredPartials == 2);
+
+    // party 2 straggles past the deadline
+    auto local    = DecryptionCoordinator::LocalSource(pipeline);
+    auto straggle = [&local](usint party, const Ciphertext<DCRTPoly>& ct) {
+        if (party == 1) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        }
+        return local(party, ct);
+    };
+    slots = coordinator.Decrypt(aggregate, straggle)->GetRealPackedValue();
+    CHECK(Near(slots[0], expected[0]));
+    CHECK(coordinator.GetStats().speculativeRecoveries >= 3);
+    CHECK(coordinator.GetStats().latenciesMs.size() == 2);
+}
+
+int main() {
+    TestRecoveredDecryption();
+    TestParallelRecovery();
+    TestAdditiveRecovery();
+    TestThresholdDecryption();
+    TestCoordinatedDecryption();
+    return TestResult();
+}
@@ -0,0 +1,88 @@
+#include "openfhe.h"
+
+#include "encoder.h"
+#include "testing.h"
+
+using namespace lbcrypto;
+
+// SAEncoder round trips: encoded values decrypt to the same slots, with every
+// other slot zero, for CKKS and BGV contexts.
+
+CryptoContext<DCRTPoly> CKKSContext(usint batchSize) {
+    CCParams<CryptoContextCKKSRNS> parameters;
+    parameters.SetSecurityLevel(HEStd_NotSet);
+    parameters.SetRingDim(1024);
+    parameters.SetMultiplicativeDepth(1);
+    parameters.SetScalingModSize(50);
+    parameters.SetBatchSize(batchSize);
+    CryptoContext<DCRTPoly> cc = GenCryptoContext(parameters);
+    cc->Enable(PKE);
+    return cc;
+}
+
+CryptoContext<DCRTPoly> BGVContext(usint batchSize) {
+    CCParams<CryptoContextBGVRNS> parameters;
+    parameters.SetSecurityLevel(HEStd_NotSet);
+    parameters.SetRingDim(1024);
+    parameters.SetMultiplicativeDepth(1);
+    parameters.SetPlaintextModulus(65537);
+    parameters.SetBatchSize(batchSize);
+    CryptoContext<DCRTPoly> cc = GenCryptoContext(parameters);
+    cc->Enable(PKE);
+    return cc;
+}
+
+void TestCKKSRoundTrip() {
+    const usint batchSize = 16;
+    auto cc               = CKKSContext(batchSize);
+    auto keys             = cc->KeyGen();
+    SAEncoder encoder(cc, batchSize);
+
+    Plaintext result;
+    cc->Decrypt(cc->Encrypt(keys.publicKey, encoder.Encode(int64_t(7))), keys.secretKey, &result);
+    result->SetLength(batchSize);
+    auto slots = result->GetRealPackedValue();
+    CHECK(Near(slots[0], 7));
+    for (usint i = 1; i < batchSize; ++i) {
+        CHECK(Near(slots[i], 0));
+    }
+
+    const std::vector<int64_t> values = {3, -4, 5};
+    const usint offset                = 6;
+    cc->Decrypt(cc->Encrypt(keys.publicKey, encoder.Encode(values, offset)), keys.secretKey, &result);
+    result->SetLength(batchSize);
+    slots = result->GetRealPackedValue();
+    for (usint i = 0; i < batchSize; ++i) {
+        const bool inRange = i >= offset && i < offset + values.size();
+        CHECK(Near(slots[i], inRange ? values[i - offset] : 0));
+    }
+
+    CHECK_THROWS(encoder.Encode(values, batchSize - 2));
+}
+
+void TestBGVRoundTrip() {
+    const usint batchSize = 16;
+    auto cc               = BGVContext(batchSize);
+    auto keys             = cc->KeyGen();
+    SAEncoder encoder(cc, batchSize);
+
+    const std::vector<int64_t> values = {11, 0, -12};
+    const usint offset                = 2;
+    Plaintext result;
+    cc->Decrypt(cc->Encrypt(keys.publicKey, encoder.Encode(values, offset)), keys.secretKey, &result);
+    result->SetLength(batchSize);
+    const auto& slots = result->GetPackedValue();
+    for (usint i = 0; i < batchSize; ++i) {
+        const bool inRange = i >= offset && i < offset + values.size();
+        CHECK(slots[i] == (inRange ? values[i - offset] : 0));
+    }
+
+    // BGV slots are integers
+    CHECK_THROWS(encoder.Encode(std::vector<double>{0.5}));
+}
+
+int main() {
+    TestCKKSRoundTrip();
+    TestBGVRoundTrip();
+    return TestResult();
+}
@@ -0,0 +1,63 @@
+#include "openfhe.h"
+
+#include "keyceremony.h"
+#include "pipeline.h"
+#include "testing.h"
+
+using namespace lbcrypto;
+
+// Joint eval keys from the key ceremony: ciphertexts evaluated with them
+// threshold-decrypt correctly, so no key of party 1 alone shadows a joint key
+// under the shared key tag.
+
+const usint NUM_PARTIES = 4;
+const usint BATCH_SIZE  = 16;
+
+Ciphertext<DCRTPoly> EncryptSlots(const SchemeSwitchPipeline& pipeline, const std::vector<double>& slots) {
+    const auto& cc = pipeline.GetCryptoContext();
+    return cc->Encrypt(pipeline.GetJointPublicKey(), cc->MakeCKKSPackedPlaintext(slots, 1, 0, nullptr, BATCH_SIZE));
+}
+
+void TestEvalSumKeys(const SchemeSwitchPipeline& pipeline) {
+    EvalKeyPlan plan;
+    plan.sum = true;
+    KeyCeremony(pipeline.GetCryptoContext(), pipeline.GetThreadPool())
+        .GenerateEvalKeys(pipeline.GetParties(), pipeline.GetJointPublicKey()->GetKeyTag(), plan);
+
+    std::vector<double> slots(BATCH_SIZE);
+    for (usint i = 0; i < BATCH_SIZE; ++i) {
+        slots[i] = i + 1;
+    }
+    auto sum    = pipeline.GetCryptoContext()->EvalSum(EncryptSlots(pipeline, slots), BATCH_SIZE);
+    auto result = pipeline.Decrypt(sum)->GetRealPackedValue();
+    CHECK(Near(result[0], BATCH_SIZE * (BATCH_SIZE + 1) / 2));
+}
+
+void TestRotationKeys(const SchemeSwitchPipeline& pipeline) {
+    EvalKeyPlan plan;
+    plan.rotations = {1, 4};
+    KeyCeremony(pipeline.GetCryptoContext(), pipeline.GetThreadPool())
+        .GenerateEvalKeys(pipeline.GetParties(), pipeline.GetJointPublicKey()->GetKeyTag(), plan);
+
+    std::vector<double> slots(BATCH_SIZE);
+    slots[4] = 3;
+    slots[5] = 7;
+    const auto& cc = pipeline.GetCryptoContext();
+    auto ct        = EncryptSlots(pipeline, slots);
+    auto rotated   = pipeline.Decrypt(cc->EvalAtIndex(cc->EvalAtIndex(ct, 4), 1))->GetRealPackedValue();
+    CHECK(Near(rotated[0], 7));
+    CHECK(Near(rotated[1], 0));
+}
+
+int main() {
+    PipelineParams params = TestParams(NUM_PARTIES);
+    params.batchSize      = BATCH_SIZE;
+    SchemeSwitchPipeline pipeline(params);
+    pipeline.Setup();
+
+    TestEvalSumKeys(pipeline);
+    // the rotation keys join the EvalSum keys under the same tag; both must still work
+    TestRotationKeys(pipeline);
+    TestEvalSumKeys(pipeline);
+    return TestResult();
+}
@@ -0,0 +1,69 @@
+#include "openfhe.h"
+
+#include "keystore.h"
+#include "pipeline.h"
+#include "testing.h"
+
+#include <filesystem>
+
+using namespace lbcrypto;
+
+// KeyStore round trips: a pipeline warm-started from the store of an earlier
+// one encrypts, aggregates, threshold-checks and decrypts like it without
+// disturbing the other pipelines in the process, and a store saved for other
+// parameters is not loaded.
+
+double CheckThreshold(SchemeSwitchPipeline& pipeline, double threshold) {
+    pipeline.SetValues(TestValues(pipeline.GetParams().numParties));
+    auto aggregate = pipeline.Aggregate(pipeline.EncryptAll());
+    return pipeline.Decrypt(pipeline.EvaluateThreshold(aggregate, threshold))->GetRealPackedValue()[0];
+}
+
+int main() {
+    const usint numParties = 4;
+    PipelineParams params  = TestParams(numParties);
+    params.keyStoreDir     = TestPath("keystore");
+    params.faultTolerant   = true;
+
+    // a pipeline without a store whose eval keys must survive the loads below
+    SchemeSwitchPipeline bystander(TestParams(numParties));
+    bystander.Setup();
+    CHECK(CheckThreshold(bystander, 7) > 0);
+
+    // the values sum to 10
+    double generated = 0;
+    {
+        SchemeSwitchPipeline pipeline(params);
+        CHECK(!pipeline.Setup());
+        CHECK(KeyStore(params.keyStoreDir).IsValidFor(params));
+        generated = CheckThreshold(pipeline, 7);
+    }
+    {
+        SchemeSwitchPipeline pipeline(params);
+        CHECK(pipeline.Setup());
+        CHECK(CheckThreshold(bystander, 7) > 0);
+        CHECK(pipeline.GetParties().size() == numParties);
+        CHECK(pipeline.GetGeneratedEvalKeys().mult);
+        CHECK(Near(CheckThreshold(pipeline, 7), generated));
+
+        // the key shares were stored as well
+        auto slots = pipeline.Decrypt(pipeline.Aggregate(pipeline.EncryptAll()), {0})->GetRealPackedValue();
+        CHECK(Near(slots[0], 10));
+    }
+
+    PipelineParams other = params;
+    other.batchSize      = 32;
+    CHECK(!KeyStore(params.keyStoreDir).IsValidFor(other));
+    other                = params;
+    other.signIterations = 2;
+    CHECK(!KeyStore(params.keyStoreDir).IsValidFor(other));
+    other                = params;
+    other.batchSize      = 32;
+    {
+        SchemeSwitchPipeline pipeline(other);
+        CHECK(!pipeline.Setup());
+    }
+
+    std::filesystem::remove_all(params.keyStoreDir);
+    return TestResult();
+}
@@ -0,0 +1,103 @@
+#include "openfhe.h"
+
+#include "pipeline.h"
+#include "queryrunner.h"
+#include "testing.h"
+
+using namespace lbcrypto;
+
+// QueryRunner: query lines parse to 0-based party sets or are rejected, the
+// decision rule of the "max" and "sign" kernels decides every integer against
+// integer and fractional thresholds from the decrypted kernel output, and
+// queries on one key epoch reuse the cached aggregate.
+
+void TestParseQuery() {
+    const usint numParties = 4;
+    ThresholdQuery query;
+
+    CHECK(!QueryRunner::ParseQuery("", numParties, query));
+    CHECK(!QueryRunner::ParseQuery("   ", numParties, query));
+    CHECK(!QueryRunner::ParseQuery("# a comment", numParties, query));
+
+    CHECK(QueryRunner::ParseQuery("17.5", numParties, query));
+    CHECK(query.threshold == 17.5);
+    CHECK(query.parties.empty());
+
+    CHECK(QueryRunner::ParseQuery(" 3 1,2,4  # trailing comment", numParties, query));
+    CHECK(query.threshold == 3);
+    CHECK((query.parties == std::set<usint>{0, 1, 3}));
+
+    // malformed thresholds
+    CHECK_THROWS(QueryRunner::ParseQuery("abc", numParties, query));
+    CHECK_THROWS(QueryRunner::ParseQuery("12x 1,2", numParties, query));
+    CHECK_THROWS(QueryRunner::ParseQuery("inf", numParties, query));
+    CHECK_THROWS(QueryRunner::ParseQuery("nan", numParties, query));
+    // malformed party lists
+    CHECK_THROWS(QueryRunner::ParseQuery("5 0", numParties, query));
+    CHECK_THROWS(QueryRunner::ParseQuery("5 5", numParties, query));
+    CHECK_THROWS(QueryRunner::ParseQuery("5 1,,2", numParties, query));
+    CHECK_THROWS(QueryRunner::ParseQuery("5 1;2", numParties, query));
+    CHECK_THROWS(QueryRunner::ParseQuery("5 -1", numParties, query));
+    CHECK_THROWS(QueryRunner::ParseQuery("5 1,2 3", numParties, query));
+}
+
+void TestDecisionRule() {
+    for (const std::string kernel : {"max", "sign"}) {
+        PipelineParams params = TestParams(2);
+        params.batchSize      = 32;
+        params.upperBound     = 20;
+        params.comparison     = kernel;
+        SchemeSwitchPipeline pipeline(params);
+        pipeline.Setup();
+
+        // slot x holds x for every x in the bounds
+        const auto& cc = pipeline.GetCryptoContext();
+        std::vector<double> xs(params.batchSize, 0);
+        for (usint x = 0; x <= params.upperBound; ++x) {
+            xs[x] = x;
+        }
+        auto ct = cc->Encrypt(pipeline.GetJointPublicKey(), cc->MakeCKKSPackedPlaintext(xs));
+
+        // integer thresholds decide x == t - 1, t, t + 1; fractional ones sit
+        // next to the kink of the max kernel's ReLU (x == 16 against 16.5)
+        for (double threshold : {0.0, 1.0, 7.9, 10.0, 16.5, 19.0, 20.0}) {
+            auto values = pipeline.Decrypt(pipeline.EvaluateThreshold(ct, threshold))->GetRealPackedValue();
+            for (usint x = 0; x <= params.upperBound; ++x) {
+                CHECK(pipeline.IsAboveThreshold(values[x], threshold) == (x > threshold));
+            }
+        }
+    }
+}
+
+void TestRun() {
+    const usint numParties = 4;
+    SchemeSwitchPipeline pipeline(TestParams(numParties));
+    pipeline.Setup();
+    pipeline.SetValues(TestValues(numParties));
+    QueryRunner runner(pipeline, pipeline.EncryptAll());
+
+    // the values sum to 10, parties 1 and 3 to 4
+    ThresholdQuery query;
+    QueryRunner::ParseQuery("7", numParties, query);
+    QueryResult result = runner.Run(query);
+    CHECK(result.crossed);
+    CHECK(result.aggregated);
+
+    QueryRunner::ParseQuery("12", numParties, query);
+    result = runner.Run(query);
+    CHECK(!result.crossed);
+    CHECK(!result.aggregated);
+
+    QueryRunner::ParseQuery("3 1,3", numParties, query);
+    result = runner.Run(query);
+    CHECK(result.crossed);
+    CHECK(result.aggregated);
+    CHECK(runner.GetStats().latenciesMs.size() == 3);
+}
+
+int main() {
+    TestParseQuery();
+    TestDecisionRule();
+    TestRun();
+    return TestResult();
+}
@@ -0,0 +1,101 @@
+#ifndef OPENFHE_TESTING_H
+#define OPENFHE_TESTING_H
+
+#include "openfhe.h"
+
+#include "pipeline.h"
+
+#include <cmath>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+using namespace lbcrypto;
+
+/**
+ * Minimal checks for the CTest executables in this folder. A failed check
+ * prints its location and is counted; main returns TestResult(), so ctest
+ * reports the executable as failed if any check did.
+ */
+inline int& TestFailures() {
+    static int failures = 0;
+    return failures;
+}
+
+inline int TestResult() {
+    if (TestFailures() > 0) {
+        std::cerr << TestFailures() << " check(s) failed" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+#define CHECK(condition)                                                                            \
+    do {                                                                                            \
+        if (!(condition)) {                                                                         \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #condition ") failed" << std::endl; \
+            ++TestFailures();                                                                       \
+        }                                                                                           \
+    } while (0)
+
+#define CHECK_THROWS(statement)                                                                         \
+    do {                                                                                                \
+        bool thrown = false;                                                                            \
+        try {                                                                                           \
+            statement;                                                                                  \
+        }                                                                                               \
+        catch (const std::exception&) {                                                                 \
+            thrown = true;                                                                              \
+        }                                                                                               \
+        if (!thrown) {                                                                                  \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": " #statement " did not throw" << std::endl; \
+            ++TestFailures();                                                                           \
+        }                                                                                               \
+    } while (0)
+
+// CKKS decrypts to the encoded integers plus a small error
+const double TEST_TOLERANCE = 0.01;
+
+inline bool Near(double actual, double expected) {
+    return std::fabs(actual - expected) < TEST_TOLERANCE;
+}
+
+/**
+ * Small, insecure parameters that keep every test well under a second per
+ * ceremony: ring dimension 1024 and the one-iteration sign kernel.
+ */
+inline PipelineParams TestParams(usint numParties) {
+    PipelineParams params;
+    params.numParties     = numParties;
+    params.batchSize      = 16;
+    params.securityLevel  = HEStd_NotSet;
+    params.ringDim        = 1024;
+    params.comparison     = "sign";
+    params.signIterations = 1;
+    return params;
+}
+
+/**
+ * Fresh path in the temp directory, unique per process; anything at it is removed.
+ */
+inline std::string TestPath(const std::string& name) {
+    auto path = std::filesystem::temp_directory_path() / ("sa_to_fhe_" + std::to_string(getpid()) + "_" + name);
+    std::filesystem::remove_all(path);
+    return path.string();
+}
+
+/**
+ * 1, 2, ..., numParties: distinct values whose sums identify the aggregated parties.
+ */
+inline std::vector<int64_t> TestValues(usint numParties) {
+    std::vector<int64_t> values(numParties);
+    for (usint i = 0; i < numParties; ++i) {
+        values[i] = i + 1;
+    }
+    return values;
+}
+
+#endif  //OPENFHE_TESTING_H
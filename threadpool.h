@@ -0,0 +1,165 @@
+#ifndef OPENFHE_THREADPOOL_H
+#define OPENFHE_THREADPOOL_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * Fixed-size pool of worker threads used to run independent per-party work
+ * (encoding, encryption, partial decryption, ...) concurrently.
+ */
+class ThreadPool {
+public:
+    /**
+     * @param numThreads - number of workers; 0 selects std::thread::hardware_concurrency()
+     */
+    explicit ThreadPool(size_t numThreads = 0) {
+        if (numThreads == 0) {
+            numThreads = std::max<size_t>(1, std::thread::hardware_concurrency());
+        }
+        for (size_t i = 0; i < numThreads; ++i) {
+            workers.emplace_back([this] { WorkerLoop(); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            stopping = true;
+        }
+        cv.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&)            = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t Size() const {
+        return workers.size();
+    }
+
+    /**
+     * Queue a task and return a future for its result. Exceptions thrown by the
+     * task are rethrown from future::get().
+     */
+    template <typename F>
+    auto Submit(F&& task) -> std::future<std::invoke_result_t<F>> {
+        using R  = std::invoke_result_t<F>;
+        auto job = std::make_shared<std::packaged_task<R()>>(std::forward<F>(task));
+        std::future<R> result = job->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            tasks.emplace([job] { (*job)(); });
+        }
+        cv.notify_one();
+        return result;
+    }
+
+    /**
+     * Run fn(i) for every i in [begin, end) on the pool and block until all
+     * iterations finished. The first exception raised by an iteration is
+     * rethrown after the remaining iterations completed.
+     */
+    void ParallelFor(size_t begin, size_t end, const std::function<void(size_t)>& fn) {
+        if (begin >= end) {
+            return;
+        }
+        // Running a single iteration, or calling from one of our own workers,
+        // would only add queueing overhead (or deadlock), so do it inline.
+        if (end - begin == 1 || IsWorkerThread()) {
+            for (size_t i = begin; i < end; ++i) {
+                fn(i);
+            }
+            return;
+        }
+
+        std::vector<std::future<void>> pending;
+        pending.reserve(end - begin);
+        for (size_t i = begin; i < end; ++i) {
+            pending.push_back(Submit([&fn, i] { fn(i); }));
+        }
+
+        std::exception_ptr firstError;
+        for (auto& f : pending) {
+            try {
+                f.get();
+            }
+            catch (...) {
+                if (!firstError) {
+                    firstError = std::current_exception();
+                }
+            }
+        }
+        if (firstError) {
+            std::rethrow_exception(firstError);
+        }
+    }
+
+    /**
+     * Reduces items with a balanced binary tree of depth ceil(log2(n)); the
+     * independent pairs of every level are combined concurrently.
+     * @param combine - combine(T& acc, const T& other) folds other into acc
+     */
+    template <typename T, typename Combine>
+    T TreeReduce(std::vector<T> items, Combine combine) {
+        if (items.empty()) {
+            throw std::invalid_argument("TreeReduce needs at least one item");
+        }
+        const size_t n = items.size();
+        for (size_t stride = 1; stride < n; stride *= 2) {
+            // pairs (i, i + stride) for i = 0, 2 * stride, 4 * stride, ... with i + stride < n
+            size_t numPairs = (n + stride - 1) / (2 * stride);
+            ParallelFor(0, numPairs, [&](size_t k) {
+                size_t i = 2 * stride * k;
+                combine(items[i], items[i + stride]);
+            });
+        }
+        return std::move(items[0]);
+    }
+
+    bool IsWorkerThread() const {
+        auto self = std::this_thread::get_id();
+        for (const auto& worker : workers) {
+            if (worker.get_id() == self) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    void WorkerLoop() {
+        for (;;) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                cv.wait(lock, [this] { return stopping || !tasks.empty(); });
+                if (stopping && tasks.empty()) {
+                    return;
+                }
+                task = std::move(tasks.front());
+                tasks.pop();
+            }
+            task();
+        }
+    }
+
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool stopping = false;
+};
+
+#endif  //OPENFHE_THREADPOOL_H
@@ -0,0 +1,135 @@
+#include "tracer.h"
+
+#include "openfhe.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+
+using namespace lbcrypto;
+
+namespace {
+
+double Ms(std::chrono::steady_clock::duration d) {
+    return std::chrono::duration<double, std::milli>(d).count();
+}
+
+double Us(std::chrono::steady_clock::duration d) {
+    return std::chrono::duration<double, std::micro>(d).count();
+}
+
+}  // namespace
+
+Tracer::Tracer() : origin(std::chrono::steady_clock::now()) {}
+
+void Tracer::Reset() {
+    std::lock_guard<std::mutex> lock(mtx);
+    origin = std::chrono::steady_clock::now();
+    spans.clear();
+    counters.clear();
+    threads.clear();
+}
+
+uint32_t Tracer::ThreadIndex(std::thread::id id) {
+    auto it = threads.find(id);
+    if (it == threads.end()) {
+        it = threads.emplace(id, static_cast<uint32_t>(threads.size()) + 1).first;
+    }
+    return it->second;
+}
+
+void Tracer::AddSpan(const char* name, uint32_t party, std::chrono::steady_clock::time_point start,
+                     std::chrono::steady_clock::time_point end) {
+    std::lock_guard<std::mutex> lock(mtx);
+    spans.push_back({name, party, ThreadIndex(std::this_thread::get_id()), start, end});
+}
+
+void Tracer::AddCount(const char* name, uint64_t n) {
+    std::lock_guard<std::mutex> lock(mtx);
+    counters[name] += n;
+}
+
+std::map<std::string, uint64_t> Tracer::GetCounters() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return counters;
+}
+
+std::map<std::string, SpanSummary> Tracer::GetSummary() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    std::map<std::string, SpanSummary> summary;
+    std::map<std::string, std::map<uint32_t, double>> partyMs;
+    for (const TraceSpan& span : spans) {
+        const double ms    = Ms(span.end - span.start);
+        SpanSummary& entry = summary[span.name];
+        ++entry.count;
+        entry.totalMs += ms;
+        entry.maxMs = std::max(entry.maxMs, ms);
+        if (span.party > 0) {
+            partyMs[span.name][span.party] += ms;
+        }
+    }
+    for (const auto& [name, perParty] : partyMs) {
+        SpanSummary& entry = summary[name];
+        for (const auto& [party, ms] : perParty) {
+            if (ms > entry.slowestPartyMs) {
+                entry.slowestParty   = party;
+                entry.slowestPartyMs = ms;
+            }
+        }
+    }
+    return summary;
+}
+
+void Tracer::WriteChromeTrace(std::ostream& os) const {
+    std::lock_guard<std::mutex> lock(mtx);
+    auto end = origin;
+    os << std::fixed << std::setprecision(3) << "{\"traceEvents\": [";
+    bool first = true;
+    for (const TraceSpan& span : spans) {
+        os << (first ? "\n" : ",\n") << "  {\"name\": \"" << span.name << "\", \"cat\": \"scheme_switch\", \"ph\": \"X\""
+           << ", \"ts\": " << Us(span.start - origin) << ", \"dur\": " << Us(span.end - span.start)
+           << ", \"pid\": 1, \"tid\": " << span.thread;
+        if (span.party > 0) {
+            os << ", \"args\": {\"party\": " << span.party << "}";
+        }
+        os << "}";
+        end   = std::max(end, span.end);
+        first = false;
+    }
+    for (const auto& [name, value] : counters) {
+        os << (first ? "\n" : ",\n") << "  {\"name\": \"" << name << "\", \"ph\": \"C\", \"ts\": " << Us(end - origin)
+           << ", \"pid\": 1, \"args\": {\"value\": " << value << "}}";
+        first = false;
+    }
+    os << "\n], \"displayTimeUnit\": \"ms\"}\n";
+}
+
+void Tracer::WriteChromeTrace(const std::string& path) const {
+    std::ofstream os(path);
+    if (!os.is_open()) {
+        OPENFHE_THROW(openfhe_error, "Cannot write the trace to " + path);
+    }
+    WriteChromeTrace(os);
+}
+
+void Tracer::WriteSummary(std::ostream& os) const {
+    const auto summary = GetSummary();
+    const auto counts  = GetCounters();
+
+    const std::ios_base::fmtflags flags = os.flags();
+    os << std::fixed << std::setprecision(3);
+    os << std::left << std::setw(24) << "span" << std::right << std::setw(8) << "count" << std::setw(14) << "total ms"
+       << std::setw(12) << "mean ms" << std::setw(12) << "max ms" << "   slowest party" << std::endl;
+    for (const auto& [name, entry] : summary) {
+        os << std::left << std::setw(24) << name << std::right << std::setw(8) << entry.count << std::setw(14)
+           << entry.totalMs << std::setw(12) << entry.totalMs / entry.count << std::setw(12) << entry.maxMs;
+        if (entry.slowestParty > 0) {
+            os << "   " << entry.slowestParty << " (" << entry.slowestPartyMs << " ms)";
+        }
+        os << std::endl;
+    }
+    for (const auto& [name, value] : counts) {
+        os << std::left << std::setw(24) << name << std::right << std::setw(8) << value << std::endl;
+    }
+    os.flags(flags);
+}
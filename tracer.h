@@ -0,0 +1,153 @@
+#ifndef OPENFHE_TRACER_H
+#define OPENFHE_TRACER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * One timed section of the pipeline. party is the 1-based id of the party the
+ * work was done for, 0 for work that belongs to no single party.
+ */
+struct TraceSpan {
+    const char* name;
+    uint32_t party;
+    uint32_t thread;
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::time_point end;
+};
+
+/**
+ * Aggregate of all spans with one name, as printed by Tracer::WriteSummary.
+ */
+struct SpanSummary {
+    size_t count   = 0;
+    double totalMs = 0;
+    double maxMs   = 0;
+    // party with the largest total time in these spans (0 if none)
+    uint32_t slowestParty = 0;
+    double slowestPartyMs = 0;
+};
+
+/**
+ * Process-wide recorder of timed spans (see TraceScope) and named counters
+ * (see TraceCount) across the SA to FHE pipeline. Disabled by default; while
+ * disabled, every scope and counter costs one relaxed atomic load. The
+ * recording can be exported as Chrome trace event JSON, which chrome://tracing
+ * and Perfetto open directly, and as a per-phase summary table.
+ *
+ * Operation counters cover what the pipeline itself issues: key switches of
+ * its rotations, relinearizations and squarings, the levels (rescales) the
+ * threshold check consumes and the bytes (de)serialized. Work inside OpenFHE
+ * calls such as EvalChebyshevSeries or the NTTs of Encrypt is not observable
+ * from here and only shows up in the spans around them.
+ */
+class Tracer {
+public:
+    // inline, so that disabled scopes do not leave the caller
+    static Tracer& Global() {
+        static Tracer tracer;
+        return tracer;
+    }
+
+    void Enable(bool enable) {
+        enabled.store(enable, std::memory_order_relaxed);
+    }
+
+    bool IsEnabled() const {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Drops all spans and counters and restarts the trace clock.
+     */
+    void Reset();
+
+    void AddSpan(const char* name, uint32_t party, std::chrono::steady_clock::time_point start,
+                 std::chrono::steady_clock::time_point end);
+
+    void AddCount(const char* name, uint64_t n);
+
+    std::map<std::string, uint64_t> GetCounters() const;
+
+    std::map<std::string, SpanSummary> GetSummary() const;
+
+    /**
+     * Writes all spans as complete ("X") events, one track per thread with the
+     * party in the event args, and the final counter values as counter ("C")
+     * events.
+     */
+    void WriteChromeTrace(std::ostream& os) const;
+
+    /**
+     * Writes the Chrome trace to path; throws if the file cannot be written.
+     */
+    void WriteChromeTrace(const std::string& path) const;
+
+    /**
+     * Table of count, total, mean and max time and the slowest party per span
+     * name, followed by the counters.
+     */
+    void WriteSummary(std::ostream& os) const;
+
+private:
+    Tracer();
+
+    // small sequential id of the calling thread; mtx must be held
+    uint32_t ThreadIndex(std::thread::id id);
+
+    std::atomic<bool> enabled{false};
+
+    mutable std::mutex mtx;
+    std::chrono::steady_clock::time_point origin;
+    std::vector<TraceSpan> spans;
+    std::map<std::string, uint64_t> counters;
+    std::map<std::thread::id, uint32_t> threads;
+};
+
+/**
+ * Records the lifetime of the scope as a span of the global tracer, if it is
+ * enabled when the scope is entered.
+ */
+class TraceScope {
+public:
+    explicit TraceScope(const char* name, uint32_t party = 0) : name(name), party(party) {
+        if (Tracer::Global().IsEnabled()) {
+            active = true;
+            start  = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~TraceScope() {
+        if (active) {
+            Tracer::Global().AddSpan(name, party, start, std::chrono::steady_clock::now());
+        }
+    }
+
+    TraceScope(const TraceScope&)            = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name;
+    uint32_t party;
+    bool active = false;
+    std::chrono::steady_clock::time_point start;
+};
+
+/**
+ * Adds n to the counter name of the global tracer, if it is enabled.
+ */
+inline void TraceCount(const char* name, uint64_t n = 1) {
+    Tracer& tracer = Tracer::Global();
+    if (tracer.IsEnabled()) {
+        tracer.AddCount(name, n);
+    }
+}
+
+#endif  //OPENFHE_TRACER_H